@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+BenchmarkState::BenchmarkState(size_t iterationCount)
+    : iterations(iterationCount), remaining(iterationCount), itemsProcessed(0),
+      elapsed(std::chrono::steady_clock::duration::zero()), started(false) {
+}
+
+bool BenchmarkState::keepRunning() {
+    if (!started) {
+        started = true;
+        start = std::chrono::steady_clock::now();
+    }
+
+    if (remaining == 0) {
+        elapsed = std::chrono::steady_clock::now() - start;
+        return false;
+    }
+
+    remaining--;
+    return true;
+}
+
+size_t BenchmarkState::getIterations() const {
+    return iterations;
+}
+
+void BenchmarkState::setItemsProcessed(size_t items) {
+    itemsProcessed = items;
+}
+
+size_t BenchmarkState::getItemsProcessed() const {
+    return itemsProcessed;
+}
+
+double BenchmarkState::getElapsedSeconds() const {
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+BenchmarkRunner::BenchmarkRunner() : minTimeSeconds(0.2), repetitions(5) {
+}
+
+bool BenchmarkRunner::parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto valueOf = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+
+        try {
+            if (arg.rfind("--filter=", 0) == 0) {
+                filter = valueOf("--filter=");
+            } else if (arg.rfind("--json=", 0) == 0) {
+                jsonPath = valueOf("--json=");
+            } else if (arg.rfind("--min-time=", 0) == 0) {
+                minTimeSeconds = std::stod(valueOf("--min-time="));
+            } else if (arg.rfind("--repetitions=", 0) == 0) {
+                repetitions = std::max(1, std::stoi(valueOf("--repetitions=")));
+            } else if (arg.rfind("--data-dir=", 0) == 0 || arg.rfind("--trace=", 0) == 0 || arg.rfind("--export-header=", 0) == 0
+                       || arg == "--quantization-report" || arg == "--pruning-report" || arg == "--low-rank-report") {
+                // Handled by main()
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Unknown or invalid argument: " << arg << "\n"
+                      << "Usage: " << argv[0] << " [--filter=substring] [--json=path] [--min-time=seconds]"
+                      << " [--repetitions=n] [--data-dir=path] [--trace=path] [--quantization-report] [--pruning-report] [--low-rank-report] [--export-header=path]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void BenchmarkRunner::add(const std::string& name, std::function<void(BenchmarkState&)> function, size_t fixedIterations) {
+    entries.push_back({name, std::move(function), fixedIterations});
+}
+
+BenchmarkResult BenchmarkRunner::run(const Entry& entry) const {
+    // Calibrate: grow the iteration count until one run takes at least minTimeSeconds
+    size_t iterations = entry.fixedIterations;
+    if (iterations == 0) {
+        iterations = 1;
+        while (true) {
+            BenchmarkState probe(iterations);
+            entry.function(probe);
+            double seconds = probe.getElapsedSeconds();
+            if (seconds >= minTimeSeconds || iterations >= (size_t(1) << 30)) {
+                break;
+            }
+            double scale = seconds > 0.0 ? std::min(10.0, 1.4 * minTimeSeconds / seconds) : 10.0;
+            iterations = std::max(iterations + 1, static_cast<size_t>(iterations * scale));
+        }
+    }
+
+    // Measure
+    std::vector<double> perIterationNs;
+    size_t items = 0;
+    for (size_t r = 0; r < repetitions; r++) {
+        BenchmarkState state(iterations);
+        entry.function(state);
+        perIterationNs.push_back(state.getElapsedSeconds() * 1e9 / iterations);
+        items = state.getItemsProcessed();
+    }
+
+    BenchmarkResult result;
+    result.name = entry.name;
+    result.iterations = iterations;
+    result.repetitions = repetitions;
+
+    std::vector<double> sorted = perIterationNs;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    result.medianNs = (n % 2 == 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    result.minNs = sorted.front();
+    result.meanNs = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+
+    double variance = 0.0;
+    for (double t : sorted) {
+        variance += (t - result.meanNs) * (t - result.meanNs);
+    }
+    result.stddevNs = n > 1 ? std::sqrt(variance / (n - 1)) : 0.0;
+
+    if (items > 0 && result.medianNs > 0.0) {
+        result.itemsPerSecond = (static_cast<double>(items) / iterations) / (result.medianNs * 1e-9);
+    }
+
+    return result;
+}
+
+int BenchmarkRunner::runAll() {
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right << std::setw(14) << "Median"
+              << std::setw(14) << "Stddev" << std::setw(12) << "Iterations" << std::setw(16) << "Items/s" << "\n"
+              << std::string(108, '-') << std::endl;
+
+    for (const auto& entry : entries) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchmarkResult result;
+        try {
+            result = run(entry);
+        } catch (const std::exception& e) {
+            std::cerr << entry.name << ": " << e.what() << std::endl;
+            return 1;
+        }
+        results.push_back(result);
+
+        std::stringstream median, stddev;
+        median << std::fixed << std::setprecision(1) << result.medianNs << " ns";
+        stddev << std::fixed << std::setprecision(1) << result.stddevNs << " ns";
+
+        std::cout << std::left << std::setw(52) << result.name << std::right << std::setw(14) << median.str()
+                  << std::setw(14) << stddev.str() << std::setw(12) << result.iterations;
+        if (result.itemsPerSecond > 0.0) {
+            std::cout << std::setw(16) << std::fixed << std::setprecision(0) << result.itemsPerSecond;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath)) {
+        std::cerr << "Could not write " << jsonPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+bool BenchmarkRunner::writeJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    file << std::setprecision(10);
+    file << "{\n  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(__clang__)
+         << "    \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n"
+#elif defined(__GNUC__)
+         << "    \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n"
+#elif defined(_MSC_VER)
+         << "    \"compiler\": \"msvc " << _MSC_VER << "\",\n"
+#endif
+#ifdef NDEBUG
+         << "    \"assertions\": false,\n"
+#else
+         << "    \"assertions\": true,\n"
+#endif
+         << "    \"min_time_seconds\": " << minTimeSeconds << ",\n"
+         << "    \"repetitions\": " << repetitions << "\n  },\n"
+         << "  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& r = results[i];
+        file << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+             << ", \"repetitions\": " << r.repetitions
+             << ", \"median_ns\": " << r.medianNs << ", \"mean_ns\": " << r.meanNs
+             << ", \"stddev_ns\": " << r.stddevNs << ", \"min_ns\": " << r.minNs
+             << ", \"items_per_second\": " << r.itemsPerSecond << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n}\n";
+    return true;
+}
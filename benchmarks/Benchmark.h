@@ -0,0 +1,116 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal self-contained benchmark harness. A benchmark is a function that
+// does its setup, then runs the measured code inside `while (state.keepRunning())`.
+// Only the loop is timed. The runner calibrates the iteration count to a
+// minimum run time, repeats the measurement, and reports the median, mean,
+// standard deviation and minimum per iteration, to the console and optionally
+// as JSON.
+
+class BenchmarkState {
+private:
+    size_t iterations;
+    size_t remaining;
+    size_t itemsProcessed;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration elapsed;
+    bool started;
+
+public:
+    explicit BenchmarkState(size_t iterationCount);
+
+    // Returns true while iterations remain; the first call starts the timer, the last stops it
+    bool keepRunning();
+
+    // Number of iterations this run will execute
+    size_t getIterations() const;
+
+    // Items (samples, bytes...) processed over the whole run, for throughput reporting
+    void setItemsProcessed(size_t items);
+    size_t getItemsProcessed() const;
+
+    // Time spent inside the keepRunning() loop
+    double getElapsedSeconds() const;
+};
+
+// Keep the compiler from optimizing a result away
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Result of one benchmark (times per iteration, in nanoseconds)
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations = 0;
+    size_t repetitions = 0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double minNs = 0.0;
+    double itemsPerSecond = 0.0;    // Based on the median; 0 if the benchmark reports no items
+};
+
+class BenchmarkRunner {
+private:
+    struct Entry {
+        std::string name;
+        std::function<void(BenchmarkState&)> function;
+        size_t fixedIterations;     // 0 = calibrate
+    };
+
+    std::vector<Entry> entries;
+    std::vector<BenchmarkResult> results;
+
+    // Options
+    std::string filter;
+    std::string jsonPath;
+    double minTimeSeconds;
+    size_t repetitions;
+
+    BenchmarkResult run(const Entry& entry) const;
+
+public:
+    BenchmarkRunner();
+
+    // Parse --filter=, --json=, --min-time=, --repetitions=; returns false (after printing usage) on bad input
+    bool parseArguments(int argc, char** argv);
+
+    // Register a benchmark; fixedIterations > 0 skips calibration (for slow, whole-epoch cases)
+    void add(const std::string& name, std::function<void(BenchmarkState&)> function, size_t fixedIterations = 0);
+
+    // Run all benchmarks matching the filter, print them, and write JSON if requested
+    int runAll();
+
+    // Write the collected results as JSON
+    bool writeJson(const std::string& path) const;
+};
+
+// Benchmark groups (one per source file)
+void registerNetworkBenchmarks(BenchmarkRunner& runner, const std::string& dataDir);
+
+// Train a small network, quantize it to int8 and print accuracy, latency and size against double precision
+void printQuantizationReport(const std::string& dataDir);
+
+// Train a small network, prune it to 90% sparsity with fine-tuning and compare CSR inference to dense
+void printPruningReport(const std::string& dataDir);
+
+// Train a small network and report accuracy and latency of its SVD-factored first layer by rank
+void printLowRankReport(const std::string& dataDir);
+
+// Train a small network and write it as a standalone inference header (see HeaderExport.h)
+void exportTrainedHeader(const std::string& dataDir, const std::string& path);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,504 @@
+#include "Benchmark.h"
+#include "Network.h"
+#include "StaticNetwork.h"
+#include "QuantizedNetwork.h"
+#include "SparseNetwork.h"
+#include "Pruning.h"
+#include "LowRankNetwork.h"
+#include "HeaderExport.h"
+#include "IncrementalPredictor.h"
+#include <chrono>
+#include <memory>
+
+namespace {
+
+// A network shape such as {784, 128, 10}: hidden layers use ReLU, the last layer softmax
+using Topology = std::vector<size_t>;
+
+std::string topologyName(const Topology& topology) {
+    std::string name;
+    for (size_t i = 0; i < topology.size(); i++) {
+        name += (i ? "-" : "") + std::to_string(topology[i]);
+    }
+    return name;
+}
+
+void buildNetwork(Network& network, const Topology& topology) {
+    // The first entry is the input size, which Network fixes at 784
+    for (size_t i = 1; i < topology.size(); i++) {
+        bool isOutput = (i + 1 == topology.size());
+        network.addLayer(topology[i], isOutput ? ActivationType::SOFTMAX : ActivationType::RELU);
+    }
+}
+
+// Real MNIST samples, so sparsity and value ranges match training
+struct Dataset {
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> targets;
+};
+
+const Dataset& trainingSubset(const std::string& dataDir) {
+    static Dataset dataset;
+    if (dataset.inputs.empty()) {
+        Network loader;
+        auto [inputs, targets] = loader.loadMNISTData(dataDir + "/mnist_data_train.csv", 2000);
+        if (inputs.empty()) {
+            throw std::runtime_error("No samples in " + dataDir + "/mnist_data_train.csv");
+        }
+        dataset.inputs = std::move(inputs);
+        dataset.targets = std::move(targets);
+    }
+    return dataset;
+}
+
+// Inputs for a layer: real pixels for the first layer, a ReLU-like vector otherwise
+std::vector<double> layerInputs(const std::string& dataDir, size_t size) {
+    if (size == 784) {
+        return trainingSubset(dataDir).inputs.front();
+    }
+    std::vector<double> inputs(size);
+    for (size_t i = 0; i < size; i++) {
+        inputs[i] = (i % 3 == 0) ? 0.0 : 0.01 * static_cast<double>(i % 50);
+    }
+    return inputs;
+}
+
+} // namespace
+
+void registerNetworkBenchmarks(BenchmarkRunner& runner, const std::string& dataDir) {
+    const std::vector<std::pair<size_t, size_t>> layerShapes = {{784, 16}, {784, 128}, {784, 512}, {128, 10}};
+    const std::vector<Topology> topologies = {{784, 16, 10}, {784, 128, 10}, {784, 256, 128, 10}};
+    const std::vector<int> batchSizes = {1, 10, 64};
+
+    // Single neuron dot product
+    runner.add("Neuron/computeOutput/784", [dataDir](BenchmarkState& state) {
+        Neuron neuron(784, ActivationType::RELU);
+        std::vector<double> inputs = layerInputs(dataDir, 784);
+        while (state.keepRunning()) {
+            neuron.computeOutput(inputs);
+            doNotOptimize(neuron.getOutput());
+        }
+    });
+
+    for (const auto& [inputs, outputs] : layerShapes) {
+        std::string shape = std::to_string(inputs) + "x" + std::to_string(outputs);
+
+        runner.add("Layer/forward/" + shape, [dataDir, inputs = inputs, outputs = outputs](BenchmarkState& state) {
+            Layer layer(outputs, inputs, ActivationType::RELU);
+            std::vector<double> x = layerInputs(dataDir, inputs);
+            while (state.keepRunning()) {
+                layer.forwardPropagate(x);
+                doNotOptimize(layer.getNeurons().front().getOutput());
+            }
+        });
+
+        // Hidden deltas of a layer with `inputs` neurons, fed by a next layer with `outputs` neurons
+        runner.add("Layer/backward/" + shape, [dataDir, inputs = inputs, outputs = outputs](BenchmarkState& state) {
+            Layer hidden(inputs, 784, ActivationType::RELU);
+            Layer next(outputs, inputs, ActivationType::SOFTMAX);
+            hidden.forwardPropagate(layerInputs(dataDir, 784));
+            next.forwardPropagate(hidden.getOutputs());
+            std::vector<double> targets(outputs, 0.0);
+            targets[0] = 1.0;
+            next.calculateOutputLayerDeltas(targets);
+            while (state.keepRunning()) {
+                hidden.calculateHiddenLayerDeltas(next);
+                doNotOptimize(hidden.getNeurons().front().getDelta());
+            }
+        });
+
+        // Hidden deltas of the layer below plus this layer's update, in one sweep
+        runner.add("Layer/backward+update/" + shape, [dataDir, inputs = inputs, outputs = outputs](BenchmarkState& state) {
+            Layer hidden(inputs, 784, ActivationType::RELU);
+            Layer next(outputs, inputs, ActivationType::SOFTMAX);
+            hidden.forwardPropagate(layerInputs(dataDir, 784));
+            next.forwardPropagate(hidden.getOutputs());
+            std::vector<double> targets(outputs, 0.0);
+            targets[0] = 1.0;
+            next.calculateOutputLayerDeltas(targets);
+            while (state.keepRunning()) {
+                next.propagateDeltasAndUpdateWeights(hidden, 1e-12);
+                doNotOptimize(hidden.getNeurons().front().getDelta());
+            }
+        });
+
+        runner.add("Layer/update/" + shape, [dataDir, inputs = inputs, outputs = outputs](BenchmarkState& state) {
+            Layer layer(outputs, inputs, ActivationType::RELU);
+            layer.forwardPropagate(layerInputs(dataDir, inputs));
+            for (auto& neuron : layer.getNeurons()) {
+                neuron.setDelta(0.01);
+            }
+            while (state.keepRunning()) {
+                // Tiny learning rate keeps the weights stable over millions of iterations
+                layer.updateWeights(1e-12);
+            }
+            doNotOptimize(layer.getNeurons().front().getWeights().front());
+        });
+    }
+
+    runner.add("Output/softmax+loss/10", [dataDir](BenchmarkState& state) {
+        Network network;
+        Layer output(10, 128, ActivationType::SOFTMAX);
+        output.forwardPropagate(layerInputs(dataDir, 128));
+        std::vector<double> targets = network.labelToTarget(3);
+        while (state.keepRunning()) {
+            output.applySoftmax();
+            doNotOptimize(network.calculateLoss(output.getOutputs(), targets));
+        }
+    });
+
+    runner.add("Output/fused/10", [dataDir](BenchmarkState& state) {
+        Network network;
+        Layer output(10, 128, ActivationType::SOFTMAX);
+        std::vector<double> inputs = layerInputs(dataDir, 128);
+        std::vector<double> targets = network.labelToTarget(3);
+        while (state.keepRunning()) {
+            // Includes the 10x128 weighted sums, unlike softmax+loss above
+            doNotOptimize(output.forwardPropagateWithLoss(inputs, targets));
+        }
+    });
+
+    for (const auto& topology : topologies) {
+        std::string name = topologyName(topology);
+
+        runner.add("Network/forward/" + name, [dataDir, topology](BenchmarkState& state) {
+            Network network;
+            buildNetwork(network, topology);
+            const Dataset& data = trainingSubset(dataDir);
+            size_t i = 0;
+            while (state.keepRunning()) {
+                doNotOptimize(network.forwardPropagate(data.inputs[i++ % data.inputs.size()]));
+            }
+            state.setItemsProcessed(state.getIterations());
+        });
+
+        runner.add("Network/trainSingle-bf16/" + name, [dataDir, topology](BenchmarkState& state) {
+            Network network(0.01);
+            buildNetwork(network, topology);
+            network.setWeightPrecision(WeightPrecision::BF16);
+            const Dataset& data = trainingSubset(dataDir);
+            size_t i = 0;
+            while (state.keepRunning()) {
+                size_t idx = i++ % data.inputs.size();
+                doNotOptimize(network.trainSingle(data.inputs[idx], data.targets[idx]));
+            }
+            state.setItemsProcessed(state.getIterations());
+        });
+
+        runner.add("Network/trainSingle/" + name, [dataDir, topology](BenchmarkState& state) {
+            Network network(0.01);
+            buildNetwork(network, topology);
+            const Dataset& data = trainingSubset(dataDir);
+            size_t i = 0;
+            while (state.keepRunning()) {
+                size_t idx = i++ % data.inputs.size();
+                doNotOptimize(network.trainSingle(data.inputs[idx], data.targets[idx]));
+            }
+            state.setItemsProcessed(state.getIterations());
+        });
+
+        // One pass over the 2000-sample training subset, in batches (items = samples)
+        for (int batchSize : batchSizes) {
+            runner.add("Epoch/" + name + "/batch" + std::to_string(batchSize),
+                       [dataDir, topology, batchSize](BenchmarkState& state) {
+                Network network(0.01);
+                buildNetwork(network, topology);
+                const Dataset& data = trainingSubset(dataDir);
+                while (state.keepRunning()) {
+                    for (size_t i = 0; i < data.inputs.size(); i += batchSize) {
+                        size_t end = std::min(i + batchSize, data.inputs.size());
+                        std::vector<std::vector<double>> batchInputs(data.inputs.begin() + i, data.inputs.begin() + end);
+                        std::vector<std::vector<double>> batchTargets(data.targets.begin() + i, data.targets.begin() + end);
+                        doNotOptimize(network.trainBatch(batchInputs, batchTargets));
+                    }
+                }
+                state.setItemsProcessed(state.getIterations() * data.inputs.size());
+            }, 1);
+        }
+    }
+
+    // Single-sample training and inference through very wide hidden layers, whole vs.
+    // split into one partition per pool thread (the same work on one thread when the
+    // pool has no workers)
+    for (const Topology& topology : std::vector<Topology>{{784, 4096, 10}, {784, 4096, 1024, 10}}) {
+        std::string name = topologyName(topology);
+        for (bool partitioned : {false, true}) {
+            std::string variant = partitioned ? "-partitioned/" : "/";
+
+            runner.add("Network/trainSingle-wide" + variant + name, [dataDir, topology, partitioned](BenchmarkState& state) {
+                Network network(0.01);
+                buildNetwork(network, topology);
+                network.setModelParallelism(partitioned ? 1024 : 0);
+                const Dataset& data = trainingSubset(dataDir);
+                size_t i = 0;
+                while (state.keepRunning()) {
+                    size_t idx = i++ % data.inputs.size();
+                    doNotOptimize(network.trainSingle(data.inputs[idx], data.targets[idx]));
+                }
+                state.setItemsProcessed(state.getIterations());
+            });
+
+            runner.add("Inference/wide" + variant + name, [dataDir, topology, partitioned](BenchmarkState& state) {
+                Network network;
+                buildNetwork(network, topology);
+                network.setModelParallelism(partitioned ? 1024 : 0);
+                const Dataset& data = trainingSubset(dataDir);
+                std::vector<double> outputs(10);
+                size_t i = 0;
+                while (state.keepRunning()) {
+                    network.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+                    doNotOptimize(outputs[0]);
+                }
+                state.setItemsProcessed(state.getIterations());
+            });
+        }
+    }
+
+    // Single-sample inference through the shared interface: dynamic vs. compile-time topology
+    runner.add("Inference/network/784-128-10", [dataDir](BenchmarkState& state) {
+        Network network;
+        buildNetwork(network, {784, 128, 10});
+        const InferenceModel& model = network;
+        const Dataset& data = trainingSubset(dataDir);
+        std::vector<double> outputs(10);
+        size_t i = 0;
+        while (state.keepRunning()) {
+            model.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+            doNotOptimize(outputs[0]);
+        }
+        state.setItemsProcessed(state.getIterations());
+    });
+
+    runner.add("Inference/bf16/784-128-10", [dataDir](BenchmarkState& state) {
+        Network network;
+        buildNetwork(network, {784, 128, 10});
+        network.setWeightPrecision(WeightPrecision::BF16);
+        const InferenceModel& model = network;
+        const Dataset& data = trainingSubset(dataDir);
+        std::vector<double> outputs(10);
+        size_t i = 0;
+        while (state.keepRunning()) {
+            model.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+            doNotOptimize(outputs[0]);
+        }
+        state.setItemsProcessed(state.getIterations());
+    });
+
+    runner.add("Inference/static/784-128-10", [dataDir](BenchmarkState& state) {
+        Network network;
+        buildNetwork(network, {784, 128, 10});
+        auto model = std::make_unique<StaticNetwork<784, 128, 10>>(network.getLayers());
+        const Dataset& data = trainingSubset(dataDir);
+        std::array<double, 10> outputs;
+        size_t i = 0;
+        while (state.keepRunning()) {
+            model->infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+            doNotOptimize(outputs[0]);
+        }
+        state.setItemsProcessed(state.getIterations());
+    });
+
+    runner.add("Inference/int8/784-128-10", [dataDir](BenchmarkState& state) {
+        Network network;
+        buildNetwork(network, {784, 128, 10});
+        const Dataset& data = trainingSubset(dataDir);
+        QuantizedNetwork model(network.getLayers(), data.inputs);
+        std::vector<double> outputs(10);
+        size_t i = 0;
+        while (state.keepRunning()) {
+            model.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+            doNotOptimize(outputs[0]);
+        }
+        state.setItemsProcessed(state.getIterations());
+    });
+
+    // CSR inference at several magnitude-pruning sparsities
+    for (int sparsity : {50, 80, 90, 95}) {
+        runner.add("Inference/csr-" + std::to_string(sparsity) + "/784-128-10", [dataDir, sparsity](BenchmarkState& state) {
+            Network network;
+            buildNetwork(network, {784, 128, 10});
+            Pruning::pruneByMagnitude(network.getLayers(), sparsity / 100.0, PruningScope::PER_LAYER);
+            SparseNetwork model(network.getLayers());
+            const Dataset& data = trainingSubset(dataDir);
+            std::vector<double> outputs(10);
+            size_t i = 0;
+            while (state.keepRunning()) {
+                model.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+                doNotOptimize(outputs[0]);
+            }
+            state.setItemsProcessed(state.getIterations());
+        });
+    }
+
+    // Factored first layer: latency against rank (128 is the unfactored cost plus the expansion)
+    for (size_t rank : {8, 16, 32, 64, 96, 128}) {
+        runner.add("Inference/lowrank-r" + std::to_string(rank) + "/784-128-10", [dataDir, rank](BenchmarkState& state) {
+            Network network;
+            buildNetwork(network, {784, 128, 10});
+            LowRankNetwork model(network.getLayers(), rank);
+            const Dataset& data = trainingSubset(dataDir);
+            std::vector<double> outputs(10);
+            size_t i = 0;
+            while (state.keepRunning()) {
+                model.infer(data.inputs[i++ % data.inputs.size()].data(), outputs.data());
+                doNotOptimize(outputs[0]);
+            }
+            state.setItemsProcessed(state.getIterations());
+        });
+    }
+
+    // Editing k pixels of a sample and re-predicting: rank-1 updates of the cached first
+    // layer sums vs. a full infer() of the edited input (items = edits)
+    for (size_t pixels : {1, 8, 64}) {
+        for (bool incremental : {true, false}) {
+            std::string variant = incremental ? "/" : "-full/";
+            runner.add("Inference/incremental" + variant + "784-128-10/pixels" + std::to_string(pixels),
+                       [dataDir, pixels, incremental](BenchmarkState& state) {
+                Network network;
+                buildNetwork(network, {784, 128, 10});
+                std::vector<double> input = trainingSubset(dataDir).inputs.front();
+                IncrementalPredictor predictor(network);
+                predictor.setInput(input);
+                std::vector<double> outputs(10);
+                size_t start = 0;
+                double value = 1.0;
+                while (state.keepRunning()) {
+                    // A short stroke: k pixels spread over the image, alternately drawn and erased
+                    for (size_t j = 0; j < pixels; j++) {
+                        size_t index = (start + j * 29) % input.size();
+                        if (incremental) {
+                            predictor.updatePixel(index, value);
+                        } else {
+                            input[index] = value;
+                        }
+                    }
+                    if (incremental) {
+                        doNotOptimize(predictor.predict());
+                    } else {
+                        network.infer(input.data(), outputs.data());
+                        doNotOptimize(network.getMaxOutputIndex(outputs));
+                    }
+                    start += 13;
+                    value = 1.0 - value;
+                }
+                state.setItemsProcessed(state.getIterations());
+            });
+        }
+    }
+
+    // Full metrics over the test set in one pass
+    runner.add("Evaluate/test-set/784-128-10", [dataDir](BenchmarkState& state) {
+        Network network;
+        buildNetwork(network, {784, 128, 10});
+        Dataset test;
+        std::tie(test.inputs, test.targets) = network.loadMNISTData(dataDir + "/mnist_data_test.csv");
+        Evaluator evaluator(network);
+        while (state.keepRunning()) {
+            doNotOptimize(evaluator.evaluate(test.inputs, test.targets).samples);
+        }
+        state.setItemsProcessed(state.getIterations() * test.inputs.size());
+    });
+
+    // CSV parsing of the whole test file (items = rows)
+    runner.add("IO/loadMNISTData/test", [dataDir](BenchmarkState& state) {
+        Network network;
+        size_t rows = 0;
+        while (state.keepRunning()) {
+            auto data = network.loadMNISTData(dataDir + "/mnist_data_test.csv");
+            rows = data.first.size();
+            doNotOptimize(rows);
+        }
+        state.setItemsProcessed(state.getIterations() * rows);
+    });
+}
+
+namespace {
+
+// Test accuracy and mean microseconds per classification
+std::pair<double, double> accuracyAndLatency(const InferenceModel& model, const Dataset& data) {
+    size_t correct = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < data.inputs.size(); i++) {
+        int label = static_cast<int>(std::max_element(data.targets[i].begin(), data.targets[i].end()) - data.targets[i].begin());
+        correct += (model.classify(data.inputs[i]) == label);
+    }
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return {static_cast<double>(correct) / data.inputs.size(), micros / data.inputs.size()};
+}
+
+} // namespace
+
+void printQuantizationReport(const std::string& dataDir) {
+    // Quantization error only means something for trained weights
+    Network network(0.01);
+    buildNetwork(network, {784, 128, 10});
+    network.train(dataDir + "/mnist_data_train.csv", 5, 10);
+
+    // Calibrate and evaluate on the test set
+    auto [inputs, targets] = network.loadMNISTData(dataDir + "/mnist_data_test.csv");
+    QuantizedNetwork quantized(network.getLayers(), inputs);
+    QuantizationReport report = quantized.compare(network, inputs, targets);
+
+    std::cout << "\nINT8 quantization, 784-128-10 (" << (quantized.isUsingAvx2() ? "AVX2" : "scalar") << " kernel)\n"
+              << report.toString() << std::endl;
+}
+
+void printPruningReport(const std::string& dataDir) {
+    Network network(0.01);
+    buildNetwork(network, {784, 128, 10});
+    network.train(dataDir + "/mnist_data_train.csv", 5, 10);
+
+    Dataset test;
+    std::tie(test.inputs, test.targets) = network.loadMNISTData(dataDir + "/mnist_data_test.csv");
+    auto [denseAccuracy, denseMicros] = accuracyAndLatency(network, test);
+
+    // 90% sparsity in three prune/fine-tune rounds
+    PruningStats stats = Pruning::pruneAndFinetune(network, 0.9, 3, dataDir + "/mnist_data_train.csv", 1, 10,
+                                                   PruningScope::PER_LAYER);
+    SparseNetwork sparse(network.getLayers());
+    auto [prunedAccuracy, prunedDenseMicros] = accuracyAndLatency(network, test);
+    auto [sparseAccuracy, sparseMicros] = accuracyAndLatency(sparse, test);
+
+    std::cout << "\nMagnitude pruning, 784-128-10, " << stats.getSparsity() * 100.0 << "% sparse"
+              << " (layers: " << stats.getLayerSparsity(0) * 100.0 << "%, " << stats.getLayerSparsity(1) * 100.0 << "%)\n"
+              << "Accuracy: " << denseAccuracy * 100.0 << "% (dense) vs " << prunedAccuracy * 100.0 << "% (pruned), "
+              << sparseAccuracy * 100.0 << "% (CSR)\n"
+              << "Latency:  " << denseMicros << " us (dense) vs " << prunedDenseMicros << " us (pruned, dense kernels) vs "
+              << sparseMicros << " us (CSR)\n"
+              << "Size:     CSR model is " << sparse.getModelBytes() << " bytes, density " << sparse.getDensity() * 100.0 << "%"
+              << std::endl;
+}
+
+void printLowRankReport(const std::string& dataDir) {
+    Network network(0.01);
+    buildNetwork(network, {784, 128, 10});
+    network.train(dataDir + "/mnist_data_train.csv", 5, 10);
+
+    Dataset test;
+    std::tie(test.inputs, test.targets) = network.loadMNISTData(dataDir + "/mnist_data_test.csv");
+    auto [denseAccuracy, denseMicros] = accuracyAndLatency(network, test);
+
+    LowRankNetwork model(network.getLayers(), 128);
+    std::cout << "\nLow-rank first layer, 784-128-10 (dense: " << denseAccuracy * 100.0 << "%, "
+              << denseMicros << " us, " << 784 * 128 << " first-layer multiply-adds)\n";
+    for (size_t rank : {8, 16, 32, 48, 64, 96, 128}) {
+        model.setRank(rank);
+        auto [accuracy, micros] = accuracyAndLatency(model, test);
+        std::cout << "Rank " << rank << ": " << accuracy * 100.0 << "%, " << micros << " us, "
+                  << model.getFirstLayerFlops() << " multiply-adds\n";
+    }
+
+    size_t rank = model.chooseRank(test.inputs, test.targets, 0.01);
+    auto [accuracy, micros] = accuracyAndLatency(model, test);
+    std::cout << "Smallest rank within 1 point of full rank: " << rank << " (" << accuracy * 100.0 << "%, "
+              << micros << " us, " << model.getModelBytes() << " bytes)" << std::endl;
+}
+
+void exportTrainedHeader(const std::string& dataDir, const std::string& path) {
+    Network network(0.01);
+    buildNetwork(network, {784, 128, 10});
+    network.train(dataDir + "/mnist_data_train.csv", 5, 10);
+
+    HeaderExport::write(network.getLayers(), path, "mnist_model");
+    std::cout << "Wrote " << path << " (namespace mnist_model)" << std::endl;
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+#include "Trace.h"
+#include <iostream>
+#include <string>
+
+#ifndef NN_DATA_DIR
+#define NN_DATA_DIR "data"
+#endif
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner;
+    if (!runner.parseArguments(argc, argv)) {
+        return 1;
+    }
+
+    // MNIST CSV files used by the data-driven benchmarks
+    std::string dataDir = NN_DATA_DIR;
+    std::string tracePath;
+    std::string headerPath;
+    bool quantizationReport = false;
+    bool pruningReport = false;
+    bool lowRankReport = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--data-dir=", 0) == 0) {
+            dataDir = arg.substr(std::string("--data-dir=").size());
+        } else if (arg.rfind("--trace=", 0) == 0) {
+            tracePath = arg.substr(std::string("--trace=").size());
+        } else if (arg.rfind("--export-header=", 0) == 0) {
+            headerPath = arg.substr(std::string("--export-header=").size());
+        } else if (arg == "--quantization-report") {
+            quantizationReport = true;
+        } else if (arg == "--pruning-report") {
+            pruningReport = true;
+        } else if (arg == "--low-rank-report") {
+            lowRankReport = true;
+        }
+    }
+
+    // Reports and exports replace the benchmark run
+    if (quantizationReport || pruningReport || lowRankReport || !headerPath.empty()) {
+        if (quantizationReport) {
+            printQuantizationReport(dataDir);
+        }
+        if (pruningReport) {
+            printPruningReport(dataDir);
+        }
+        if (lowRankReport) {
+            printLowRankReport(dataDir);
+        }
+        if (!headerPath.empty()) {
+            exportTrainedHeader(dataDir, headerPath);
+        }
+        return 0;
+    }
+
+    registerNetworkBenchmarks(runner, dataDir);
+
+    int status = runner.runAll();
+
+    // Spans are only recorded when built with -DENABLE_TRACING=ON
+    if (!tracePath.empty()) {
+        if (!Tracer::writeChromeTrace(tracePath)) {
+            std::cerr << "Could not write " << tracePath << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << Tracer::getEventCount() << " trace events to " << tracePath
+                  << " (" << Tracer::getDroppedCount() << " dropped)" << std::endl;
+    }
+
+    return status;
+}
@@ -0,0 +1,93 @@
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#include <cstddef>
+
+enum class ActivationType {
+    RELU,
+    SOFTMAX,
+    LEAKY_RELU,
+    TANH,
+    SIGMOID,
+    GELU
+};
+
+// Activation functions as compile-time policies. Each policy provides two
+// array kernels with no per-element dispatch, so a layer picks its policy
+// once and the compiler can vectorize the loop:
+//
+//   apply(x, y, n)          y[i] = f(x[i])
+//   derivative(x, y, d, n)  d[i] = f'(x[i]), given y[i] = f(x[i])
+//
+// x is the pre-activation (weighted sum). x and y must not overlap.
+// Transcendental functions use Softmax::fastExp (~1e-9 relative error).
+namespace Activation {
+    struct Relu {
+        static void apply(const double* x, double* y, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                y[i] = x[i] > 0.0 ? x[i] : 0.0;
+            }
+        }
+
+        static void derivative(const double* x, const double*, double* d, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                d[i] = x[i] > 0.0 ? 1.0 : 0.0;
+            }
+        }
+    };
+
+    struct LeakyRelu {
+        static constexpr double NEGATIVE_SLOPE = 0.01;
+
+        static void apply(const double* x, double* y, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                y[i] = x[i] > 0.0 ? x[i] : NEGATIVE_SLOPE * x[i];
+            }
+        }
+
+        static void derivative(const double* x, const double*, double* d, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                d[i] = x[i] > 0.0 ? 1.0 : NEGATIVE_SLOPE;
+            }
+        }
+    };
+
+    // tanh(x) = 1 - 2 / (exp(2x) + 1)
+    struct Tanh {
+        static void apply(const double* x, double* y, size_t n);
+        static void derivative(const double* x, const double* y, double* d, size_t n);
+    };
+
+    // sigmoid(x) = 1 / (1 + exp(-x))
+    struct Sigmoid {
+        static void apply(const double* x, double* y, size_t n);
+        static void derivative(const double* x, const double* y, double* d, size_t n);
+    };
+
+    // GELU, tanh approximation: 0.5x * (1 + tanh(sqrt(2/pi) * (x + 0.044715x^3)))
+    struct Gelu {
+        static void apply(const double* x, double* y, size_t n);
+        static void derivative(const double* x, const double* y, double* d, size_t n);
+    };
+
+    // Per-neuron part of softmax: the layer normalizes afterwards (see Softmax::forward)
+    struct Identity {
+        static void apply(const double* x, double* y, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                y[i] = x[i];
+            }
+        }
+
+        static void derivative(const double*, const double*, double* d, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                d[i] = 1.0;
+            }
+        }
+    };
+
+    // Select the policy for a runtime type once per call, then run its kernel
+    void apply(ActivationType type, const double* x, double* y, size_t n);
+    void derivative(ActivationType type, const double* x, const double* y, double* d, size_t n);
+}
+
+#endif // ACTIVATION_H
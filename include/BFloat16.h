@@ -0,0 +1,38 @@
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// bfloat16: the top 16 bits of an IEEE float (8-bit exponent, 7-bit mantissa).
+// Used as a compact forward-pass copy of the double master weights; products
+// are accumulated in float.
+namespace BFloat16 {
+    // Round to nearest even (NaN payloads are not preserved)
+    inline uint16_t fromFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        bits += 0x7FFF + ((bits >> 16) & 1);
+        return static_cast<uint16_t>(bits >> 16);
+    }
+
+    inline float toFloat(uint16_t value) {
+        uint32_t bits = static_cast<uint32_t>(value) << 16;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    // Convert count doubles (branch-free loop the compiler can vectorize)
+    void fromDoubles(const double* values, uint16_t* converted, size_t count);
+
+    // sum of weights[i] * inputs[i], accumulated in float
+    float dot(const uint16_t* weights, const float* inputs, size_t count);
+
+    // Same, over only the listed inputs (all others are zero)
+    float sparseDot(const uint16_t* weights, const double* inputs, const std::vector<size_t>& activeInputs);
+}
+
+#endif // BFLOAT16_H
@@ -0,0 +1,51 @@
+#ifndef BATCH_SCORER_H
+#define BATCH_SCORER_H
+
+#include <string>
+#include <cstddef>
+#include "InferenceModel.h"
+
+struct ScoringOptions {
+    size_t threads = 0;                 // Chunks scored at once on the shared pool; 0 = the pool's concurrency
+    size_t chunkSamples = 4096;         // Lines parsed, scored and written as one unit
+    size_t batchSize = 64;              // Samples per InferenceModel::inferBatch call
+    bool writeProbabilities = true;     // Append the output probabilities to each prediction
+};
+
+struct ScoringStats {
+    size_t samples = 0;
+    double seconds = 0.0;
+    double samplesPerSecond = 0.0;
+    size_t bytesRead = 0;
+    size_t bytesWritten = 0;
+};
+
+// Offline scoring of a CSV file of any size.
+//
+// Each input line is an image in the MNIST CSV layout: 784 pixel values
+// (0-255), optionally preceded by a label, which is ignored. Each output line
+// is the predicted class, then (with writeProbabilities) the output
+// probabilities, in the same order as the input lines.
+//
+// The calling thread reads the file in large blocks and cuts it into chunks of
+// whole lines. Each chunk is parsed, scored (in batches) and formatted into
+// its own output buffer by a task on the shared ThreadPool. A writer thread
+// writes finished chunks strictly in input order with one fwrite per chunk. At
+// most a few chunks per scoring slot are in flight, so memory stays bounded
+// however large the input is.
+class BatchScorer {
+private:
+    const InferenceModel& model;
+    ScoringOptions options;
+
+public:
+    // The model must outlive the scorer and be safe to call from several threads
+    // (true for every InferenceModel in this project)
+    BatchScorer(const InferenceModel& model, const ScoringOptions& options = ScoringOptions());
+
+    // Score every line of inputPath into outputPath; throws std::runtime_error
+    // on I/O errors or malformed lines
+    ScoringStats score(const std::string& inputPath, const std::string& outputPath) const;
+};
+
+#endif // BATCH_SCORER_H
@@ -0,0 +1,61 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "InferenceModel.h"
+
+// Classification metrics from one pass over a labeled data set
+struct EvaluationReport {
+    size_t samples = 0;
+    double loss = 0.0;                              // Mean cross-entropy
+    std::vector<std::vector<size_t>> confusion;     // [actual][predicted] counts
+    std::vector<size_t> topKCorrect;                // [k - 1]: samples whose label is among the k most probable outputs
+
+    double getAccuracy() const;
+    double getTopKAccuracy(size_t k) const;
+
+    // Of the samples predicted (precision) or labeled (recall) as the class, the fraction
+    // that were right; 0 when there are none
+    double getPrecision(size_t label) const;
+    double getRecall(size_t label) const;
+
+    // Summary, per-class precision/recall and the confusion matrix, for the console
+    std::string toString() const;
+};
+
+// Parallel evaluation of any InferenceModel.
+//
+// The samples are split into a few contiguous shards per thread, which run as
+// tasks on the shared ThreadPool. Each shard goes through
+// InferenceModel::inferBatch and fills its own report; the reports are summed
+// at the end, so shards share nothing while running. Counts don't depend on
+// the thread count (the summed loss can differ in the last bits).
+class Evaluator {
+private:
+    const InferenceModel& model;
+    size_t threads;
+    size_t maxTopK;
+
+    static constexpr size_t BATCH_SIZE = 64;
+    static constexpr size_t SHARDS_PER_THREAD = 4;  // Lets idle threads steal from slow ones
+
+    // Accumulate samples [begin, end) into report
+    void evaluateShard(const std::vector<std::vector<double>>& inputs,
+                       const std::vector<std::vector<double>>& targets,
+                       size_t begin, size_t end, EvaluationReport& report) const;
+
+public:
+    // Split the work for `threads` threads of the shared pool (0 = the pool's
+    // concurrency, 1 = only the calling thread); top-k accuracy is reported for
+    // k = 1..maxTopK
+    explicit Evaluator(const InferenceModel& model, size_t threads = 0, size_t maxTopK = 5);
+
+    // Evaluate the first maxSamples samples (all of them when negative)
+    EvaluationReport evaluate(const std::vector<std::vector<double>>& inputs,
+                              const std::vector<std::vector<double>>& targets,
+                              int maxSamples = -1) const;
+};
+
+#endif // EVALUATOR_H
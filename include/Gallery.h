@@ -0,0 +1,94 @@
+#ifndef GALLERY_H
+#define GALLERY_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include "WeightSnapshot.h"
+
+// Scrollable grid of many MNIST digits. All digits are packed once into a
+// single atlas texture (one bulk upload), and the visible tiles are drawn as
+// two vertex arrays, so scrolling costs a few draw calls regardless of how
+// many samples are loaded. Each tile is framed green/red depending on whether
+// the current model classifies it correctly; predictions are computed on a
+// background thread over an immutable weight snapshot.
+class Gallery {
+private:
+    sf::Vector2f position;
+    sf::Vector2f size;
+
+    // Visual properties
+    float tileSize;                 // On-screen size of one tile, including its frame
+    float tileBorder;               // Width of the color-coded frame
+    size_t columns;                 // Tiles per row on screen
+    size_t visibleRows;             // Fully visible rows on screen
+    size_t firstRow;                // First visible row (scroll position)
+
+    // Colors
+    sf::Color pendingColor;
+    sf::Color correctColor;
+    sf::Color incorrectColor;
+
+    // Font for the summary line
+    sf::Font font;
+
+    // Samples (owned by the caller, must outlive the gallery and stay unchanged)
+    const std::vector<std::vector<double>>* images;
+    std::vector<int> labels;
+    size_t sampleCount;             // Samples that fit in the atlas
+
+    // Atlas texture holding every digit
+    sf::Texture atlasTexture;
+    size_t atlasColumns;            // Digits per row in the atlas
+
+    // Geometry for the visible tiles
+    sf::VertexArray frameVertices;
+    sf::VertexArray tileVertices;
+    bool geometryDirty;
+
+    // Background predictions: worker fills predictions[0..completed) in order
+    std::vector<int> predictions;
+    std::atomic<size_t> completed;
+    std::atomic<bool> cancelRequested;
+    std::thread worker;
+    size_t completedAtLastRebuild;
+    size_t correctCount;
+
+    // Stop the background worker if it is running
+    void stopPredictions();
+
+    // Rebuild the vertex arrays for the visible rows
+    void rebuildGeometry();
+
+public:
+    Gallery(const sf::Vector2f& pos, const sf::Vector2f& gallerySize, const sf::Font& fontRef);
+    ~Gallery();
+
+    Gallery(const Gallery&) = delete;
+    Gallery& operator=(const Gallery&) = delete;
+
+    // Pack the given samples into the atlas texture
+    void setSamples(const std::vector<std::vector<double>>& sampleImages, const std::vector<int>& sampleLabels);
+
+    // Start classifying all samples with the snapshot's weights in the background
+    void startPredictions(std::shared_ptr<const NetworkSnapshot> snapshot);
+
+    // Pick up new predictions from the worker (call once per frame)
+    void update();
+
+    // Scroll by whole rows (positive delta scrolls up, as with the mouse wheel)
+    void scroll(float delta);
+
+    // Index of the sample under the mouse, or -1
+    int getSampleIndexAt(const sf::Vector2i& mousePosition) const;
+
+    // Draw the gallery
+    void draw(sf::RenderWindow& window) const;
+
+    // Get number of samples shown
+    size_t getSampleCount() const;
+};
+
+#endif // GALLERY_H
@@ -0,0 +1,36 @@
+#ifndef HEADER_EXPORT_H
+#define HEADER_EXPORT_H
+
+#include <vector>
+#include <string>
+#include "Layer.h"
+
+// Code generator for embedding a trained network in another program.
+//
+// The generated header depends only on <cstddef> and <cstdint> (plus <cmath>
+// for tanh/sigmoid/GELU layers). Every weight and bias is an `inline constexpr`
+// 64-byte aligned array, and each layer is a call to a dense kernel templated
+// on its sizes, so the compiler sees fixed trip counts and can inline the whole
+// forward pass. There is no runtime loading, allocation or iostream.
+//
+//   namespace <name> {
+//       constexpr std::size_t INPUT_SIZE = 784;
+//       constexpr std::size_t OUTPUT_SIZE = 10;
+//       // Raw 0-255 pixels in, most probable class out
+//       inline int predict(const std::uint8_t* pixels);
+//   }
+//
+// Pixels are scaled by 1/255 exactly as Network::loadMNISTData does, and
+// weights are written with full double precision, so predict() returns the
+// same class as the source network. Softmax is monotonic, so predict() takes
+// the argmax of the output weighted sums without computing it.
+namespace HeaderExport {
+    // Header source for the layers, with everything inside `namespaceName`
+    // (a C++ identifier, also used for the include guard)
+    std::string generate(const std::vector<Layer>& layers, const std::string& namespaceName);
+
+    // Write generate() to path; throws std::runtime_error if the file can't be written
+    void write(const std::vector<Layer>& layers, const std::string& path, const std::string& namespaceName);
+}
+
+#endif // HEADER_EXPORT_H
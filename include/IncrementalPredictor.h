@@ -0,0 +1,57 @@
+#ifndef INCREMENTAL_PREDICTOR_H
+#define INCREMENTAL_PREDICTOR_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "Network.h"
+
+// Incremental inference for inputs that change a few pixels at a time
+// (drawing canvas, image editor). The first layer's weighted sums are cached
+// for the current input, and each pixel edit applies a rank-1 update to them,
+// so an edit costs O(changed pixels x first layer size) plus the small
+// remaining layers instead of a full 784 x H pass.
+//
+// The cache uses the same weights as the first layer's forward pass (the
+// bfloat16 copy under WeightPrecision::BF16), so predictions agree with
+// Network::infer. The predictor reads weights from the network on every call,
+// so the network must outlive it. After the weights or their precision change
+// (training, setWeightPrecision), call setInput() again to rebuild the cache.
+class IncrementalPredictor {
+private:
+    const Network& network;
+    std::vector<double> currentInput;     // Input the cache corresponds to
+    std::vector<double> firstLayerSums;   // Cached first layer pre-activations
+    size_t editsSinceRefresh;             // Pixel edits applied since last full recompute
+    size_t refreshInterval;               // Edits after which the cache is recomputed to bound drift
+
+    // Recompute the cached first layer sums from scratch
+    void refresh();
+
+public:
+    // Constructor
+    IncrementalPredictor(const Network& network, size_t refreshInterval = 4096);
+
+    // Set a new input and compute the first layer cache in full
+    void setInput(const std::vector<double>& input);
+
+    // Change a single pixel and update the cache
+    void updatePixel(size_t index, double value);
+
+    // Change several pixels at once (pairs of index and new value)
+    void updatePixels(const std::vector<std::pair<size_t, double>>& changes);
+
+    // Output layer activations for the current input
+    std::vector<double> getOutputs() const;
+
+    // Activations for all layers (same layout as Network::getAllActivations)
+    std::vector<std::vector<double>> getAllActivations() const;
+
+    // Predicted digit for the current input
+    int predict() const;
+
+    // Current input
+    const std::vector<double>& getInput() const;
+};
+
+#endif // INCREMENTAL_PREDICTOR_H
@@ -0,0 +1,42 @@
+#ifndef INFERENCE_MODEL_H
+#define INFERENCE_MODEL_H
+
+#include <vector>
+#include <cstddef>
+
+// Read-only inference interface shared by the dynamic Network and the
+// fixed-topology StaticNetwork, so callers can swap one for the other
+class InferenceModel {
+public:
+    virtual ~InferenceModel() = default;
+
+    // Input and output vector sizes
+    virtual size_t getInputSize() const = 0;
+    virtual size_t getOutputSize() const = 0;
+
+    // Output probabilities for one input: reads getInputSize() values from input
+    // and writes getOutputSize() values to outputs, without modifying the model
+    virtual void infer(const double* input, double* outputs) const = 0;
+
+    // infer() for `count` inputs stored back to back, writing count * getOutputSize()
+    // outputs. Models override this to share work across the batch.
+    virtual void inferBatch(const double* inputs, size_t count, double* outputs) const;
+
+    // Index of the most probable output
+    virtual int classify(const double* input) const;
+
+    // Convenience overloads for vectors (size-checked)
+    std::vector<double> infer(const std::vector<double>& input) const;
+    int classify(const std::vector<double>& input) const;
+};
+
+// The calling thread's instance of a model's per-call buffers. infer() is const
+// and may run on many threads at once, so buffers can't live in the model; one
+// set per thread, grown on first use, keeps repeated calls from allocating.
+template <typename Scratch>
+Scratch& threadLocalScratch() {
+    thread_local Scratch scratch;
+    return scratch;
+}
+
+#endif // INFERENCE_MODEL_H
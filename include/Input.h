@@ -15,7 +15,7 @@ private:
     std::vector<int> labels;                 // Store labels for all images
     sf::RectangleShape imageDisplay;         // For displaying the current image
     sf::Texture imageTexture;                // Texture for the image
-    sf::Image sfImage;                       // SFML Image object
+    std::vector<sf::Uint8> pixelBuffer;      // RGBA pixels uploaded to the texture in one call
     
     size_t currentIndex;                     // Index of currently displayed image
     bool dataLoaded;                         // Flag indicating if data is loaded
@@ -56,6 +56,13 @@ public:
     // Get number of loaded images
     size_t getImageCount() const;
     
+    // Get all loaded images and labels
+    const std::vector<std::vector<double>>& getImages() const;
+    const std::vector<int>& getLabels() const;
+    
+    // Select a specific image
+    void setCurrentIndex(size_t index);
+    
     // Check if data is loaded
     bool isDataLoaded() const;
 };
@@ -3,18 +3,81 @@
 
 #include <vector>
 #include <cmath>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include "Neuron.h"
+#include "Activation.h"
+
+// Weight storage used by a layer's forward pass. Updates always go to the
+// double-precision master weights held by the neurons.
+enum class WeightPrecision {
+    DOUBLE,     // Forward pass reads the master weights directly
+    BF16        // Forward pass reads a bfloat16 copy (4x less weight traffic), accumulating in float
+};
 
 class Layer {
 private:
     std::vector<Neuron> neurons;
     size_t neuronCount;
+    size_t inputCount;
     ActivationType activationType;
     std::vector<double> layerInputs; // Stores the most recent inputs to this layer
     
+    // Indices of the nonzero entries in layerInputs, when sparse enough to be worth using
+    std::vector<size_t> activeInputs;
+    bool sparseInputs;
+    
+    // Rows (neurons) visited and skipped by the weight updates because their delta was zero
+    size_t updatedRowCount;
+    size_t skippedRowCount;
+    
+    // Weighted sums (pre-activations) from the most recent forward pass
+    std::vector<double> preActivations;
+    
+    // Scratch buffers for the activation, derivative and fused softmax output kernels
+    std::vector<double> outputValues;
+    std::vector<double> gradientValues;
+    
+    // Scratch buffer for the transposed product in calculateHiddenLayerDeltas
+    std::vector<double> deltaSums;
+    
+    // Reduced-precision forward-pass copy of the weights (row-major, one row per neuron),
+    // kept in sync with the master weights after every update
+    WeightPrecision weightPrecision;
+    std::vector<uint16_t> forwardWeights;
+    std::vector<float> floatInputs;
+    
+    // Slices of neurons processed in parallel on the shared ThreadPool (1 = all on the calling thread)
+    size_t partitionCount;
+    
+    // Pruning mask (row-major, one row per neuron): weights with a 0 entry are held at zero
+    std::vector<uint8_t> pruningMask;
+    
+    // Zero the pruned weights of one row after an update (only the active input
+    // columns, when those were the only ones updated)
+    void applyPruningMask(size_t row, bool onlyActiveInputs);
+    
+    // Re-convert one row of forwardWeights from its master weights (only the
+    // active input columns, when those were the only ones updated)
+    void refreshForwardWeights(size_t row, bool onlyActiveInputs);
+    
+    // Record which inputs are nonzero and choose sparse or dense kernels for this sample
+    void findActiveInputs();
+    
+    // Fill preActivations for the given inputs (sparse or dense, double or bfloat16 kernel)
+    void computeWeightedSums(const std::vector<double>& inputs);
+    
+    // propagateDeltasAndUpdateWeights() split by the previous layer's partitions (columns)
+    void propagateAndUpdateByColumns(Layer& previousLayer, double learningRate, bool skipInactiveInputs);
+    
+    // Set each neuron's delta to sums[i] times its activation derivative
+    void setDeltasFromWeightedSums(const std::vector<double>& sums);
+    
 public:
+    // Inputs at or below this fraction of nonzeros use the sparse kernels
+    static constexpr double MAX_SPARSE_INPUT_DENSITY = 0.5;
+    
     // Constructor - creates a layer with specified neurons and activation type
     Layer(size_t neuronCount, size_t inputsPerNeuron, ActivationType type);
     
@@ -24,6 +87,34 @@ public:
     // Apply softmax activation to the layer (for output layer)
     void applySoftmax();
     
+    // Fused forward pass, cross-entropy loss and output deltas for a softmax output layer.
+    // Leaves the layer as forwardPropagate + calculateOutputLayerDeltas would, and returns the loss.
+    double forwardPropagateWithLoss(const std::vector<double>& inputs, const std::vector<double>& targets);
+    
+    // Working memory for the const forward pass below, owned by the caller so that
+    // repeated inference (e.g. one per thread) doesn't allocate
+    struct InferenceScratch {
+        std::vector<double> weightedSums;
+        std::vector<size_t> activeInputs;
+        std::vector<float> floatInputs;
+    };
+    
+    // Compute outputs for the given inputs without modifying the layer state
+    std::vector<double> computeOutputs(const std::vector<double>& inputs) const;
+    
+    // Same, into outputs (resized to the neuron count); with double weights, zero
+    // inputs are skipped when they dominate, like forwardPropagate() does
+    void computeOutputs(const std::vector<double>& inputs, std::vector<double>& outputs,
+                        InferenceScratch& scratch) const;
+    
+    // computeOutputs() for `count` inputs stored back to back (count * inputCount values),
+    // writing count * neuronCount outputs. Each weight row is read once per group of
+    // samples instead of once per sample.
+    void computeOutputsBatch(const double* inputs, size_t count, double* outputs) const;
+    
+    // Apply this layer's activation to precomputed weighted sums (pre-activations)
+    std::vector<double> activateWeightedSums(const std::vector<double>& weightedSums) const;
+    
     // Backpropagation for output layer
     void calculateOutputLayerDeltas(const std::vector<double>& targets);
     
@@ -33,6 +124,11 @@ public:
     // Update weights after backpropagation
     void updateWeights(double learningRate);
     
+    // Fused backward-and-update sweep: computes previousLayer's deltas from this layer's
+    // deltas and pre-update weights, updating the weights in the same pass. Equivalent to
+    // previousLayer.calculateHiddenLayerDeltas(*this) followed by updateWeights().
+    void propagateDeltasAndUpdateWeights(Layer& previousLayer, double learningRate);
+    
     // Getters
     size_t getNeuronCount() const;
     const std::vector<Neuron>& getNeurons() const;
@@ -43,6 +139,33 @@ public:
     
     // Get activation type
     ActivationType getActivationType() const;
+    
+    // Choose the forward-pass weight storage (converts the current master weights)
+    void setWeightPrecision(WeightPrecision precision);
+    WeightPrecision getWeightPrecision() const;
+    
+    // bfloat16 forward-pass weights (neurons x inputs, row-major); empty unless BF16
+    const std::vector<uint16_t>& getForwardWeights() const;
+    
+    // Split the neurons into `count` contiguous slices that run in parallel on the
+    // shared ThreadPool (0 or 1 = no split). A slice owns its rows of this layer's
+    // weights in the forward pass and update, and its columns of the next layer's
+    // weights in the next layer's backward pass, so no two threads write the same
+    // value and results are identical to the unsplit layer. Worth it for wide
+    // layers (thousands of neurons) where a single sample is the bottleneck.
+    void setPartitionCount(size_t count);
+    size_t getPartitionCount() const;
+    
+    // Install a pruning mask (neurons x inputs, row-major; 0 = pruned). Pruned weights
+    // are zeroed now and kept at zero by every later update. An empty mask removes it.
+    void setPruningMask(const std::vector<uint8_t>& mask);
+    const std::vector<uint8_t>& getPruningMask() const;
+    
+    // Rows (neurons) whose update and delta propagation were skipped because their
+    // delta was zero (inactive ReLU units), out of all rows visited since the last reset
+    size_t getSkippedRowCount() const;
+    size_t getBackpropRowCount() const;
+    void resetSparsityStats();
 };
 
 #endif // LAYER_H 
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef LOW_RANK_NETWORK_H
+#define LOW_RANK_NETWORK_H
+
+#include <vector>
+#include <cstddef>
+#include "InferenceModel.h"
+#include "Layer.h"
+
+// Inference-only copy of a network whose first (input) layer is replaced by a
+// truncated SVD factorization W ~ U_r (U_r^T W): the 784 inputs are projected
+// onto r directions, then expanded back to the H neurons. A forward pass costs
+// r * (784 + H) multiply-adds in the first layer instead of H * 784, so it wins
+// while r < 784 * H / (784 + H) (~110 for H = 128). Later layers stay dense.
+//
+// U holds the eigenvectors of W W^T (cyclic Jacobi), ordered by decreasing
+// singular value, so U_r U_r^T W is the best rank-r approximation of W. The
+// factorization is computed once; setRank() and chooseRank() only change how
+// many of its terms the forward pass uses.
+class LowRankNetwork final : public InferenceModel {
+private:
+    struct DenseLayer {
+        size_t inputCount = 0;
+        size_t outputCount = 0;
+        ActivationType activationType = ActivationType::RELU;
+        std::vector<double> weights;        // outputCount rows of inputCount
+        std::vector<double> biases;
+    };
+
+    size_t inputCount;
+    size_t firstOutputCount;
+    ActivationType firstActivationType;
+    std::vector<double> firstBiases;
+    std::vector<double> singularValues;     // Descending
+    std::vector<double> projections;        // Row i: u_i^T W (inputCount values), by singular value
+    std::vector<double> leftVectors;        // Row j: U[j][0..maxRank), the expansion weights of neuron j
+    std::vector<double> expansion;          // Row j: U[j][0..rank), contiguous for the current rank
+    std::vector<DenseLayer> layers;         // Every layer after the first
+    size_t rank;
+
+    // Fraction of samples whose predicted class matches the one-hot target
+    double accuracy(const std::vector<std::vector<double>>& inputs,
+                    const std::vector<std::vector<double>>& targets) const;
+
+public:
+    // Factorize the first layer and copy the rest; starts at the given rank
+    LowRankNetwork(const std::vector<Layer>& sourceLayers, size_t rank);
+
+    using InferenceModel::infer;
+    using InferenceModel::classify;
+    size_t getInputSize() const override;
+    size_t getOutputSize() const override;
+    void infer(const double* input, double* outputs) const override;
+
+    // Number of factorization terms used by the first layer (1..getMaxRank())
+    void setRank(size_t newRank);
+    size_t getRank() const;
+    size_t getMaxRank() const;
+
+    // Singular values of the first layer's weights, largest first
+    const std::vector<double>& getSingularValues() const;
+
+    // Smallest rank whose accuracy on the samples is within maxAccuracyDrop
+    // (0-1) of the full-rank model's. Binary search, which assumes accuracy
+    // grows with rank; sets and returns the chosen rank.
+    size_t chooseRank(const std::vector<std::vector<double>>& inputs,
+                      const std::vector<std::vector<double>>& targets,
+                      double maxAccuracyDrop);
+
+    // First-layer multiply-adds per sample at the current rank
+    size_t getFirstLayerFlops() const;
+
+    // Bytes of weights and biases at the current rank
+    size_t getModelBytes() const;
+};
+
+#endif // LOW_RANK_NETWORK_H
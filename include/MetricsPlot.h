@@ -0,0 +1,65 @@
+#ifndef METRICS_PLOT_H
+#define METRICS_PLOT_H
+
+#include <SFML/Graphics.hpp>
+#include "TrainingMetrics.h"
+
+// Live chart of per-batch training loss and accuracy. Points are drained from
+// the trainer's ring buffer and appended to line strips stored in data
+// coordinates (x = batch index, y = value); scaling to the screen is done with
+// a render transform at draw time. Each strip holds at most about one vertex
+// per pixel of plot width: once full, adjacent vertices are averaged in pairs
+// and each vertex then covers twice as many batches, so drawing costs the same
+// after thousands of points as after a few hundred.
+class MetricsPlot {
+private:
+    sf::Vector2f position;
+    sf::Vector2f size;
+
+    // Series in data coordinates
+    sf::VertexArray lossLine;
+    sf::VertexArray accuracyLine;
+
+    // Colors
+    sf::Color lossColor;
+    sf::Color accuracyColor;
+
+    // Font for labels
+    sf::Font font;
+
+    // Data ranges and latest values
+    double maxLoss;
+    BatchMetrics latest;
+    size_t pointCount;
+
+    // Vertex budget per series (even, so full strips merge in pairs), batches per
+    // vertex, and the running sums of the last vertex's (possibly partial) batch range
+    size_t maxVertices;
+    size_t pointsPerVertex;
+    size_t pointsInLastVertex;
+    double lastLossSum;
+    double lastAccuracySum;
+
+    // Halve both series by averaging adjacent vertices
+    void mergeVertices();
+
+    // Transform from data coordinates (x in [0, xRange], y in [0, yRange]) to the plot area
+    sf::Transform makeTransform(float xRange, float yRange) const;
+
+public:
+    MetricsPlot(const sf::Vector2f& pos, const sf::Vector2f& plotSize, const sf::Font& fontRef);
+
+    // Append all metrics waiting in the buffer
+    void consume(TrainingMetricsBuffer& buffer);
+
+    // Remove all points
+    void clear();
+
+    // Draw the chart
+    void draw(sf::RenderWindow& window) const;
+
+    // Number of points plotted
+    size_t getPointCount() const;
+};
+
+#endif // METRICS_PLOT_H
@@ -11,17 +11,44 @@
 #include <memory>
 #include <cmath>
 #include <iostream>
+#include <atomic>
+#include <chrono>
 #include "Layer.h"
+#include "InferenceModel.h"
+#include "TrainingMetrics.h"
+#include "WeightSnapshot.h"
+#include "Telemetry.h"
+#include "Evaluator.h"
 
-class Network {
+class Network : public InferenceModel {
 private:
     std::vector<Layer> layers;
     double learningRate;
+    WeightPrecision weightPrecision;    // Forward-pass weight storage for all layers
+    
+    // Layers at least this wide are split into partitions (see setModelParallelism); 0 = off
+    size_t partitionMinWidth;
+    size_t partitionsPerLayer;
+    
+    // Apply the setModelParallelism() settings to one layer
+    void applyPartitioning(Layer& layer) const;
     
     // For shuffling training data
     std::random_device rd;
     std::mt19937 rng;
     
+    // Optional sink for per-batch training metrics (not owned)
+    TrainingMetricsBuffer* metricsBuffer;
+    
+    // Optional publisher of weight snapshots for concurrent readers (not owned)
+    SnapshotPublisher* snapshotPublisher;
+    
+    // If set, train() appends per-epoch telemetry to this file as JSON lines
+    std::string telemetryLogPath;
+    
+    // Set from another thread to stop train() after the current batch
+    std::atomic<bool> stopRequested;
+    
 public:
     // Constructor
     Network(double learningRate = 0.01);
@@ -29,22 +56,56 @@ public:
     // Add a layer to the network
     void addLayer(size_t neuronCount, ActivationType type);
     
+    // Choose the forward-pass weight storage for all current and future layers.
+    // BF16 runs training and inference forward passes on bfloat16 copies of the
+    // weights, while backpropagation and updates use the double master weights.
+    void setWeightPrecision(WeightPrecision precision);
+    WeightPrecision getWeightPrecision() const;
+    
+    // Split every current and future layer with at least minLayerWidth neurons into
+    // `partitions` slices of neurons (0 = one per thread of the shared ThreadPool),
+    // which run forward, backward and update in parallel (see
+    // Layer::setPartitionCount). Lowers single-sample latency for very wide layers;
+    // results don't change. minLayerWidth 0 turns it off.
+    void setModelParallelism(size_t minLayerWidth, size_t partitions = 0);
+    
     // Forward propagation through all layers
     std::vector<double> forwardPropagate(const std::vector<double>& inputs);
     
+    // Forward pass that also computes the loss and output layer deltas (fused for softmax outputs)
+    double forwardPropagateWithLoss(const std::vector<double>& inputs, const std::vector<double>& targets);
+    
     // Train on a single sample
     double trainSingle(const std::vector<double>& inputs, const std::vector<double>& targets);
     
-    // Train on a batch of samples
+    // Train on a batch of samples (optionally counting samples classified correctly before each update)
     double trainBatch(const std::vector<std::vector<double>>& batchInputs, 
-                     const std::vector<std::vector<double>>& batchTargets);
+                     const std::vector<std::vector<double>>& batchTargets,
+                     int* correctCount = nullptr);
+    
+    // Train on the entire dataset for multiple epochs, returning per-epoch performance telemetry
+    TrainingTelemetry train(const std::string& trainFile, int epochs, int batchSize);
+    
+    // Append train() telemetry to this file as JSON lines (empty path to disable)
+    void setTelemetryLog(const std::string& path);
+    
+    // Publish per-batch metrics from train() into this buffer (nullptr to disable)
+    void setMetricsBuffer(TrainingMetricsBuffer* buffer);
     
-    // Train on the entire dataset for multiple epochs
-    void train(const std::string& trainFile, int epochs, int batchSize);
+    // Publish weight snapshots from train() through this publisher (nullptr to disable)
+    void setSnapshotPublisher(SnapshotPublisher* publisher);
     
-    // Test the network on a dataset
+    // Ask a running train() call to stop after its current batch
+    void requestStop();
+    
+    // Test the network on the first numSamples samples of a dataset (all when -1);
+    // prints and returns the accuracy
     double test(const std::string& testFile, int numSamples = -1);
     
+    // Accuracy, loss, top-k accuracy, per-class metrics and confusion matrix on the first
+    // numSamples samples of a dataset (all when -1), evaluated in parallel (see Evaluator)
+    EvaluationReport evaluate(const std::string& testFile, int numSamples = -1);
+    
     // Predict the digit for a single input
     int predict(const std::vector<double>& input);
     
@@ -66,9 +127,18 @@ public:
     
     // Get layers
     const std::vector<Layer>& getLayers() const;
+    std::vector<Layer>& getLayers();
     
     // Get activations for all layers
     std::vector<std::vector<double>> getAllActivations(const std::vector<double>& input) const;
+    
+    // InferenceModel: const forward pass that leaves the layers' stored state untouched
+    using InferenceModel::infer;
+    using InferenceModel::classify;
+    size_t getInputSize() const override;
+    size_t getOutputSize() const override;
+    void infer(const double* input, double* outputs) const override;
+    void inferBatch(const double* inputs, size_t count, double* outputs) const override;
 };
 
 #endif // NETWORK_H 
\ No newline at end of file
@@ -5,11 +5,7 @@
 #include <random>
 #include <cmath>
 #include <iostream>
-
-enum class ActivationType {
-    RELU,
-    SOFTMAX
-};
+#include "Activation.h"
 
 class Neuron {
 private:
@@ -31,7 +27,14 @@ public:
     // Forward pass computation
     void computeOutput(const std::vector<double>& inputs);
     
-    // Activation functions
+    // Weighted sum of inputs plus bias (pre-activation), without changing state
+    double computeWeightedSum(const std::vector<double>& inputs) const;
+    
+    // Same, visiting only the listed inputs (all others must be zero)
+    double computeWeightedSum(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs) const;
+    
+    // Activation function and its derivative at pre-activation x (scalar
+    // versions of the Activation policy kernels that Layer runs per layer)
     double activate(double x) const;
     double activateDerivative(double x) const;
     
@@ -47,17 +50,38 @@ public:
     // Backpropagation
     void updateWeights(const std::vector<double>& inputs, double learningRate);
     
+    // Same, touching only the weights of the listed inputs (all others must be zero)
+    void updateWeights(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs, double learningRate);
+    
+    // Fused backward/update: adds delta * weight (pre-update) to weightedDeltaSums[i] for
+    // each input i, then applies the same gradient step as updateWeights
+    void propagateAndUpdateWeights(const std::vector<double>& inputs, double learningRate, double* weightedDeltaSums);
+    
+    // Same, for only the listed inputs; the others must be zero and need no weighted delta sum
+    void propagateAndUpdateWeights(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs,
+                                   double learningRate, double* weightedDeltaSums);
+    
+    // The weight part of the fused step for inputs [begin, end) only (or the listed
+    // active inputs in [firstActive, lastActive)), without the bias step, so a sweep
+    // can be split by column; updateBias() completes the step
+    void propagateAndUpdateWeightRange(const std::vector<double>& inputs, size_t begin, size_t end,
+                                       double learningRate, double* weightedDeltaSums);
+    void propagateAndUpdateWeightRange(const std::vector<double>& inputs, const size_t* firstActive,
+                                       const size_t* lastActive, double learningRate, double* weightedDeltaSums);
+    void updateBias(double learningRate);
+    
     // For output layer neurons to calculate initial deltas
     void calculateOutputDelta(double target);
     
-    // For hidden layer neurons to calculate deltas based on next layer
-    void calculateHiddenDelta(const std::vector<Neuron>& nextLayer, size_t myIndex);
-    
     // Get weights for a specific connection
     double getWeight(size_t index) const;
     
     // Get all weights
     const std::vector<double>& getWeights() const;
+    std::vector<double>& getWeights();
+    
+    // Get bias term
+    double getBias() const;
 };
 
 #endif // NEURON_H 
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Frame profiler for the GUI main loop. Sections are a fixed enum so a scoped
+// timer costs two clock reads and an array add; the last FRAME_HISTORY frames
+// are kept for percentiles. The overlay is drawn only when toggled on.
+class Profiler {
+public:
+    // Timed sections of a frame
+    enum class Section {
+        VISUALIZER_DRAW,
+        GALLERY_DRAW,
+        INPUT_DRAW,
+        BUTTON_UPDATE,
+        INFERENCE,
+        COUNT
+    };
+
+    // Times a section from construction to destruction
+    class ScopedTimer {
+    private:
+        Profiler& profiler;
+        Section section;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        ScopedTimer(Profiler& profilerRef, Section timedSection);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+    static const size_t FRAME_HISTORY = 240;  // About 4 seconds at 60 FPS
+
+private:
+    static const size_t SECTION_COUNT = static_cast<size_t>(Section::COUNT);
+
+    // Per-frame samples (ring buffers indexed by frameCount % FRAME_HISTORY)
+    std::vector<double> frameIntervals;   // Time between frame starts (includes display wait), ms
+    std::vector<double> frameWorkTimes;   // Time from frame start to endFrame(), ms
+    std::vector<size_t> frameDrawCalls;
+    std::array<std::vector<double>, SECTION_COUNT> sectionHistory;
+
+    // Accumulators for the frame in progress
+    std::array<double, SECTION_COUNT> currentSectionTimes;
+    std::array<double, SECTION_COUNT> lastSectionTimes;   // Most recent single measurement
+    std::chrono::steady_clock::time_point frameStart;
+    size_t frameCount;
+    bool frameStarted;
+
+    bool overlayVisible;
+    size_t framesSinceOverlayRefresh;
+    std::vector<std::string> overlayLines;  // Cached text, refreshed a few times a second
+
+    // Draw calls issued since the frame started
+    static size_t drawCallCounter;
+
+    // Percentile over the recorded history of a ring buffer
+    double percentile(const std::vector<double>& history, double p) const;
+
+    // Rebuild the cached overlay text
+    void refreshOverlayText();
+
+public:
+    // Constructor
+    Profiler();
+
+    // Mark the start and end of the work done in one frame
+    void beginFrame();
+    void endFrame();
+
+    // Add time spent in a section during the current frame
+    void addSectionTime(Section section, double milliseconds);
+
+    // Count one draw call (called by profiledDraw)
+    static void countDrawCall();
+
+    // Frame interval percentile in milliseconds (p in [0, 100])
+    double getFrameTimePercentile(double p) const;
+
+    // Average time per frame spent in a section over the history, in milliseconds
+    double getSectionAverage(Section section) const;
+
+    // Most recent measurement of a section, in milliseconds
+    double getLastSectionTime(Section section) const;
+
+    // Draw calls in the last completed frame
+    size_t getLastFrameDrawCalls() const;
+
+    // Show or hide the overlay
+    void toggleOverlay();
+    bool isOverlayVisible() const;
+
+    // Draw the overlay (if visible) at the given position
+    void drawOverlay(sf::RenderWindow& window, const sf::Font& font, const sf::Vector2f& position);
+
+    // Display name of a section
+    static const char* getSectionName(Section section);
+};
+
+// Draw through this helper so the profiler can count draw calls per frame
+template <typename... Args>
+inline void profiledDraw(sf::RenderTarget& target, Args&&... args) {
+    Profiler::countDrawCall();
+    target.draw(std::forward<Args>(args)...);
+}
+
+#endif // PROFILER_H
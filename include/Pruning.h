@@ -0,0 +1,41 @@
+#ifndef PRUNING_H
+#define PRUNING_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "Network.h"
+
+// Whether the magnitude threshold is shared by all layers or set per layer
+enum class PruningScope {
+    GLOBAL,     // One threshold: small layers can end up much sparser than large ones
+    PER_LAYER   // Every layer pruned to the same sparsity
+};
+
+// Zero weights per layer after pruning (biases are never pruned)
+struct PruningStats {
+    std::vector<size_t> layerWeights;
+    std::vector<size_t> layerPruned;
+
+    double getSparsity() const;
+    double getLayerSparsity(size_t layer) const;
+};
+
+// Magnitude pruning of trained weights. Pruned weights are zeroed and masked
+// (Layer::setPruningMask), so further training through Network::train keeps
+// them at zero.
+namespace Pruning {
+    // Prune the smallest-magnitude weights until `sparsity` (0-1) of the weights are zero
+    PruningStats pruneByMagnitude(std::vector<Layer>& layers, double sparsity, PruningScope scope);
+
+    // Prune to targetSparsity in `steps` equal increments, fine-tuning with
+    // network.train(trainFile, epochsPerStep, batchSize) after each one
+    PruningStats pruneAndFinetune(Network& network, double targetSparsity, int steps,
+                                  const std::string& trainFile, int epochsPerStep, int batchSize,
+                                  PruningScope scope);
+
+    // Count zero weights
+    PruningStats measure(const std::vector<Layer>& layers);
+}
+
+#endif // PRUNING_H
@@ -0,0 +1,79 @@
+#ifndef QUANTIZED_NETWORK_H
+#define QUANTIZED_NETWORK_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "InferenceModel.h"
+#include "Network.h"
+
+// Accuracy, latency and size of a quantized model against its double-precision source
+struct QuantizationReport {
+    size_t samples = 0;
+    double referenceAccuracy = 0.0;
+    double quantizedAccuracy = 0.0;
+    double agreement = 0.0;                 // Fraction of samples where both predict the same digit
+    double referenceMicrosPerSample = 0.0;
+    double quantizedMicrosPerSample = 0.0;
+    size_t referenceBytes = 0;              // Weights and biases
+    size_t quantizedBytes = 0;              // Weights, biases and scales
+
+    // Multi-line summary for the console
+    std::string toString() const;
+};
+
+// Inference-only int8 copy of a trained network (post-training quantization).
+//
+// Weights are int8 with one scale per neuron (row). Activations between layers
+// are unsigned 8-bit with one scale per layer, calibrated from the largest
+// value each layer sees on a calibration set; they use 0..127 so that the
+// AVX2 u8 x s8 pair products (_mm256_maddubs_epi16) can't saturate int16.
+// Dot products accumulate in int32 and are rescaled to float once per neuron.
+//
+// The AVX2 kernel is compiled in on x86-64 GCC/Clang (or with /arch:AVX2) and
+// chosen at runtime when the CPU supports it; otherwise a scalar kernel runs.
+// Hidden layers must use ReLU (non-negative activations) and the output softmax.
+class QuantizedNetwork final : public InferenceModel {
+private:
+    struct QuantizedLayer {
+        size_t inputCount = 0;
+        size_t outputCount = 0;
+        size_t paddedInputCount = 0;        // Row stride, a multiple of 32 bytes
+        std::vector<int8_t> weights;        // outputCount rows of paddedInputCount, zero padded
+        std::vector<float> outputScales;    // Per row: input scale * weight row scale
+        std::vector<float> biases;
+        float inputScale = 1.0f;            // Real input value = quantized value * inputScale
+    };
+
+    std::vector<QuantizedLayer> layers;
+    bool useAvx2;
+
+    // Quantize real activations to 0..ACTIVATION_MAX with the given scale
+    static void quantizeActivations(const double* values, size_t count, float scale, uint8_t* quantized);
+
+public:
+    static constexpr int ACTIVATION_MAX = 127;
+    static constexpr int WEIGHT_MAX = 127;
+
+    // Quantize the given layers, calibrating activation ranges on the sample inputs
+    QuantizedNetwork(const std::vector<Layer>& sourceLayers, const std::vector<std::vector<double>>& calibrationInputs);
+
+    using InferenceModel::infer;
+    using InferenceModel::classify;
+    size_t getInputSize() const override;
+    size_t getOutputSize() const override;
+    void infer(const double* input, double* outputs) const override;
+
+    // Bytes of weights, biases and scales
+    size_t getModelBytes() const;
+
+    // Whether the AVX2 kernel is in use
+    bool isUsingAvx2() const;
+
+    // Compare accuracy, per-sample latency and size against the source network
+    QuantizationReport compare(const Network& reference,
+                               const std::vector<std::vector<double>>& inputs,
+                               const std::vector<std::vector<double>>& targets) const;
+};
+
+#endif // QUANTIZED_NETWORK_H
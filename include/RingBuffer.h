@@ -0,0 +1,67 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+
+// Lock-free single-producer/single-consumer ring buffer with a fixed capacity.
+// One thread may call tryPush() while another calls tryPop(); neither ever
+// blocks. When the buffer is full, tryPush() fails and the item is dropped,
+// so a slow consumer can never stall the producer.
+template <typename T, size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    // Head and tail on separate cache lines so producer and consumer don't false-share
+    alignas(CACHE_LINE) std::atomic<size_t> head;   // Next slot to write (producer)
+    alignas(CACHE_LINE) std::atomic<size_t> tail;   // Next slot to read (consumer)
+    alignas(CACHE_LINE) std::array<T, Capacity> slots;
+
+public:
+    // Constructor
+    SpscRingBuffer() : head(0), tail(0), slots() {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side: returns false (and drops the item) if the buffer is full
+    bool tryPush(const T& item) {
+        size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead - tail.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+
+        slots[currentHead & (Capacity - 1)] = item;
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false if the buffer is empty
+    bool tryPop(T& item) {
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = slots[currentTail & (Capacity - 1)];
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of queued items (exact only when called from one side while the other is idle)
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    // Maximum number of items the buffer can hold
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,19 @@
+#ifndef SOFTMAX_H
+#define SOFTMAX_H
+
+#include <cstddef>
+
+// Output-layer kernels: softmax, cross-entropy loss and output deltas fused
+// over a small contiguous array that stays in cache.
+namespace Softmax {
+    // exp(x) in place for each value, accurate to about 1e-9 relative.
+    // Branch-free so the compiler can vectorize it; inputs are clamped to [-708, 709].
+    void fastExp(double* values, size_t count);
+
+    // Turns weighted sums (logits) into softmax probabilities in place.
+    // With targets, returns the cross-entropy loss (clipped at p = 1e-10 like
+    // Network::calculateLoss) and, if deltas is given, writes target - p to it.
+    double forward(double* values, size_t count, const double* targets = nullptr, double* deltas = nullptr);
+}
+
+#endif // SOFTMAX_H
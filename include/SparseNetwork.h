@@ -0,0 +1,49 @@
+#ifndef SPARSE_NETWORK_H
+#define SPARSE_NETWORK_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "InferenceModel.h"
+#include "Layer.h"
+
+// Inference-only copy of a (pruned) network with each layer's weights in
+// compressed sparse row (CSR) form: only nonzero weights and their column
+// indices are stored, and each neuron's weighted sum is a sparse row times
+// the dense input vector (SpMV). Work and memory scale with the number of
+// nonzero weights, so a 90%-sparse model does about a tenth of the
+// multiply-adds of the dense forward pass.
+class SparseNetwork final : public InferenceModel {
+private:
+    struct CsrLayer {
+        size_t inputCount = 0;
+        ActivationType activationType = ActivationType::RELU;
+        std::vector<uint32_t> rowOffsets;       // neurons + 1 entries into columns/values
+        std::vector<uint32_t> columns;
+        std::vector<double> values;
+        std::vector<double> biases;
+
+        // outputs[row] = biases[row] + sparse row . inputs
+        void multiply(const double* inputs, double* outputs) const;
+    };
+
+    std::vector<CsrLayer> layers;
+
+public:
+    // Convert layers, keeping only their nonzero weights
+    explicit SparseNetwork(const std::vector<Layer>& sourceLayers);
+
+    using InferenceModel::infer;
+    using InferenceModel::classify;
+    size_t getInputSize() const override;
+    size_t getOutputSize() const override;
+    void infer(const double* input, double* outputs) const override;
+
+    // Stored (nonzero) weights over all weights
+    double getDensity() const;
+
+    // Bytes of values, column indices, row offsets and biases
+    size_t getModelBytes() const;
+};
+
+#endif // SPARSE_NETWORK_H
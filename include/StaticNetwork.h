@@ -0,0 +1,219 @@
+#ifndef STATIC_NETWORK_H
+#define STATIC_NETWORK_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "InferenceModel.h"
+#include "Layer.h"
+#include "Softmax.h"
+
+namespace StaticKernels {
+    // One dense layer with compile-time sizes: one contiguous, cache-line aligned
+    // weight row per neuron, so the dot products have fixed trip counts the
+    // compiler can fully unroll and vectorize
+    template <size_t Inputs, size_t Outputs>
+    struct DenseLayer {
+        alignas(64) std::array<double, Inputs * Outputs> weights{};
+        alignas(64) std::array<double, Outputs> biases{};
+
+        // outputs[o] = biases[o] + row o . inputs
+        void computeWeightedSums(const double* inputs, double* outputs) const {
+            for (size_t o = 0; o < Outputs; o++) {
+                const double* row = weights.data() + o * Inputs;
+
+                // Independent accumulators break the add dependency chain
+                double sum0 = 0.0;
+                double sum1 = 0.0;
+                double sum2 = 0.0;
+                double sum3 = 0.0;
+                size_t i = 0;
+                for (; i + 4 <= Inputs; i += 4) {
+                    sum0 += row[i] * inputs[i];
+                    sum1 += row[i + 1] * inputs[i + 1];
+                    sum2 += row[i + 2] * inputs[i + 2];
+                    sum3 += row[i + 3] * inputs[i + 3];
+                }
+                for (; i < Inputs; i++) {
+                    sum0 += row[i] * inputs[i];
+                }
+
+                outputs[o] = biases[o] + ((sum0 + sum1) + (sum2 + sum3));
+            }
+        }
+
+        void load(const Layer& layer) {
+            const std::vector<Neuron>& neurons = layer.getNeurons();
+            if (neurons.size() != Outputs || neurons.front().getWeights().size() != Inputs) {
+                throw std::runtime_error("Layer shape doesn't match the static network topology");
+            }
+
+            for (size_t o = 0; o < Outputs; o++) {
+                const std::vector<double>& row = neurons[o].getWeights();
+                std::copy(row.begin(), row.end(), weights.begin() + o * Inputs);
+                biases[o] = neurons[o].getBias();
+            }
+        }
+    };
+
+    // First layer, for mostly-zero inputs (~80% of MNIST pixels): weights are stored
+    // column-major, one contiguous column of Outputs weights per input, so each
+    // nonzero input adds one fixed-length scaled column and a zero input costs a
+    // single compare. Dense inputs do the same work as DenseLayer.
+    template <size_t Inputs, size_t Outputs>
+    struct SparseInputLayer {
+        alignas(64) std::array<double, Inputs * Outputs> columns{};
+        alignas(64) std::array<double, Outputs> biases{};
+
+        // outputs = biases + sum over nonzero inputs i of inputs[i] * column i
+        void computeWeightedSums(const double* inputs, double* outputs) const {
+            std::copy(biases.begin(), biases.end(), outputs);
+            for (size_t i = 0; i < Inputs; i++) {
+                const double x = inputs[i];
+                if (x == 0.0) {
+                    continue;
+                }
+                const double* column = columns.data() + i * Outputs;
+                for (size_t o = 0; o < Outputs; o++) {
+                    outputs[o] += x * column[o];
+                }
+            }
+        }
+
+        void load(const Layer& layer) {
+            const std::vector<Neuron>& neurons = layer.getNeurons();
+            if (neurons.size() != Outputs || neurons.front().getWeights().size() != Inputs) {
+                throw std::runtime_error("Layer shape doesn't match the static network topology");
+            }
+
+            for (size_t o = 0; o < Outputs; o++) {
+                const std::vector<double>& row = neurons[o].getWeights();
+                for (size_t i = 0; i < Inputs; i++) {
+                    columns[i * Outputs + o] = row[i];
+                }
+                biases[o] = neurons[o].getBias();
+            }
+        }
+    };
+
+    // The network's first layer reads the (sparse) inputs; the others read activations
+    template <bool First, size_t Inputs, size_t Outputs>
+    using StackLayer = typename std::conditional<First, SparseInputLayer<Inputs, Outputs>, DenseLayer<Inputs, Outputs>>::type;
+
+    template <bool First, size_t... Sizes>
+    struct LayerStack;
+
+    // Output layer: softmax
+    template <bool First, size_t Inputs, size_t Outputs>
+    struct LayerStack<First, Inputs, Outputs> {
+        StackLayer<First, Inputs, Outputs> layer;
+
+        void forward(const double* inputs, double* outputs) const {
+            layer.computeWeightedSums(inputs, outputs);
+            Softmax::forward(outputs, Outputs);
+        }
+
+        void load(const std::vector<Layer>& layers, size_t index) {
+            if (layers[index].getActivationType() != ActivationType::SOFTMAX) {
+                throw std::runtime_error("Static network output layer must use softmax");
+            }
+            layer.load(layers[index]);
+        }
+    };
+
+    // Hidden layer: ReLU, then the rest of the stack
+    template <bool First, size_t Inputs, size_t Outputs, size_t Next, size_t... Rest>
+    struct LayerStack<First, Inputs, Outputs, Next, Rest...> {
+        StackLayer<First, Inputs, Outputs> layer;
+        LayerStack<false, Outputs, Next, Rest...> rest;
+
+        void forward(const double* inputs, double* outputs) const {
+            alignas(64) double hidden[Outputs];
+            layer.computeWeightedSums(inputs, hidden);
+            for (size_t i = 0; i < Outputs; i++) {
+                hidden[i] = hidden[i] > 0.0 ? hidden[i] : 0.0;
+            }
+            rest.forward(hidden, outputs);
+        }
+
+        void load(const std::vector<Layer>& layers, size_t index) {
+            if (layers[index].getActivationType() != ActivationType::RELU) {
+                throw std::runtime_error("Static network hidden layers must use ReLU");
+            }
+            layer.load(layers[index]);
+            rest.load(layers, index + 1);
+        }
+    };
+}
+
+// Inference-only network with its topology fixed at compile time, e.g.
+// StaticNetwork<784, 128, 10>: 784 inputs, a 128-unit ReLU hidden layer and a
+// 10-way softmax output. Sizes are constexpr and all weights live inline in
+// aligned arrays, so there is no per-layer allocation, no activation switch
+// and no size checking on the hot path. The first layer skips zero inputs.
+//
+// Weights are copied from a trained Network (or snapshot) of the same shape.
+// The object holds every weight inline (~800 KB for 784-128-10), so allocate
+// it on the heap (std::make_unique) rather than on the stack.
+template <size_t Inputs, size_t... LayerSizes>
+class StaticNetwork final : public InferenceModel {
+    static_assert(sizeof...(LayerSizes) >= 1, "StaticNetwork needs at least an output layer");
+
+private:
+    StaticKernels::LayerStack<true, Inputs, LayerSizes...> stack;
+
+    static constexpr std::array<size_t, sizeof...(LayerSizes)> layerSizes = {LayerSizes...};
+
+public:
+    static constexpr size_t inputSize = Inputs;
+    static constexpr size_t outputSize = layerSizes[sizeof...(LayerSizes) - 1];
+    static constexpr size_t layerCount = sizeof...(LayerSizes);
+
+    // Zero weights; call loadWeights() before inference
+    StaticNetwork() = default;
+
+    // Copy weights from layers of exactly this topology (hidden ReLU, softmax output)
+    explicit StaticNetwork(const std::vector<Layer>& layers) {
+        loadWeights(layers);
+    }
+
+    void loadWeights(const std::vector<Layer>& layers) {
+        if (layers.size() != layerCount) {
+            throw std::runtime_error("Layer count doesn't match the static network topology");
+        }
+        stack.load(layers, 0);
+    }
+
+    using InferenceModel::infer;
+    using InferenceModel::classify;
+
+    size_t getInputSize() const override {
+        return inputSize;
+    }
+
+    size_t getOutputSize() const override {
+        return outputSize;
+    }
+
+    void infer(const double* input, double* outputs) const override {
+        stack.forward(input, outputs);
+    }
+
+    int classify(const double* input) const override {
+        std::array<double, outputSize> outputs;
+        infer(input, outputs.data());
+
+        size_t best = 0;
+        for (size_t i = 1; i < outputSize; i++) {
+            if (outputs[i] > outputs[best]) {
+                best = i;
+            }
+        }
+        return static_cast<int>(best);
+    }
+};
+
+#endif // STATIC_NETWORK_H
@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Performance telemetry for one training epoch
+struct EpochTelemetry {
+    int epoch = 0;                      // Zero-based epoch index
+    size_t samples = 0;
+    size_t batches = 0;
+    double loss = 0.0;                  // Average batch loss
+
+    double wallSeconds = 0.0;
+    double samplesPerSecond = 0.0;
+
+    // Per-batch training latency (trainBatch only), in milliseconds
+    double batchLatencyP50Ms = 0.0;
+    double batchLatencyP99Ms = 0.0;
+    double batchLatencyMaxMs = 0.0;
+
+    // Where the time went: copying samples into batches vs. forward/backward/update.
+    // Reading the file happens once per train() call (TrainingTelemetry::loadSeconds).
+    double batchAssemblySeconds = 0.0;
+    double computeSeconds = 0.0;
+
+    // Fraction of neuron rows whose backprop and update were skipped (zero delta, e.g. inactive ReLU)
+    double skippedRowFraction = 0.0;
+
+    // Memory
+    size_t peakResidentBytes = 0;       // Process peak RSS at the end of the epoch
+    size_t allocations = 0;             // Heap allocations by the training thread during the epoch
+    size_t allocatedBytes = 0;
+};
+
+// Telemetry for a whole Network::train call
+struct TrainingTelemetry {
+    double loadSeconds = 0.0;           // Reading and parsing the training file
+    size_t loadAllocations = 0;         // All threads (the file is parsed in parallel)
+    std::vector<EpochTelemetry> epochs;
+
+    // Append one JSON object per epoch to a file (JSON lines); returns false on I/O error
+    bool appendJsonLines(const std::string& path) const;
+};
+
+namespace Telemetry {
+    // Heap allocations (count and bytes) made so far by the whole process, or by the
+    // calling thread. Always 0 unless built with ENABLE_ALLOCATION_COUNTING.
+    size_t getAllocationCount();
+    size_t getAllocatedBytes();
+    size_t getThreadAllocationCount();
+    size_t getThreadAllocatedBytes();
+
+    // Peak resident set size of the process in bytes (0 if unavailable)
+    size_t getPeakResidentBytes();
+
+    // p-th percentile (0-100) of the values; reorders the vector
+    double percentile(std::vector<double>& values, double p);
+
+    // One epoch as a single-line JSON object
+    std::string toJson(const EpochTelemetry& epoch, double loadSeconds);
+}
+
+#endif // TELEMETRY_H
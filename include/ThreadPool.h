@@ -0,0 +1,144 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing task scheduler shared by everything in the project that runs
+// in parallel (loading, evaluation, scoring, wide layers), so that features
+// running at the same time share one set of threads instead of each starting
+// their own and oversubscribing the machine.
+//
+// Every worker owns a deque. A worker pushes and pops its own tasks at the
+// back (newest first, still warm in cache); idle workers steal from the front
+// of other deques (oldest first, usually the biggest pieces of work). Tasks
+// submitted from outside the pool are spread round-robin over the deques.
+//
+// parallelFor() splits a range recursively: each split pushes the right half
+// for thieves and keeps the left, until pieces are at most `grain` long. The
+// calling thread works on the range too. While it waits it runs only pieces of
+// its own range (never an unrelated long task that would delay its return) and
+// otherwise sleeps until a piece is queued or the range is done. parallelFor()
+// may be called from inside a task.
+class ThreadPool {
+private:
+    // Progress of one parallelFor() call, which its caller sleeps on
+    struct RangeState {
+        std::atomic<size_t> remaining;          // Indices not yet done
+        std::atomic<size_t> queuedPieces;       // Pieces waiting in the deques
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::exception_ptr error;
+
+        explicit RangeState(size_t count) : remaining(count), queuedPieces(0) {}
+        void fail(std::exception_ptr e);
+        void finish(size_t count);
+        void notify();
+    };
+
+    // A queued function, and the parallelFor() call it is a piece of (if any)
+    struct Task {
+        std::function<void()> function;
+        RangeState* range = nullptr;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> queuedTasks;
+    std::atomic<size_t> nextQueue;          // Round-robin target for outside submissions
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    void workerLoop(size_t index, bool pin);
+    void push(Task task);
+
+    // Any task, or (with a range) only that range's pieces
+    bool tryPop(Task& task, const RangeState* range = nullptr);
+
+    // Work on the caller's range until all of it is done
+    void waitForRange(RangeState& state);
+
+public:
+    // workerCount threads (0 runs every task on the calling thread); with
+    // pinWorkers, worker i is bound to CPU (i + 1) mod CPU count (Linux only)
+    explicit ThreadPool(size_t workerCount, bool pinWorkers = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // The shared pool: one worker per hardware thread, minus one for the calling thread
+    static ThreadPool& global();
+
+    // One per hardware thread, minus one for the calling thread
+    static size_t getDefaultWorkerCount();
+
+    // Size and pin the shared pool; only before its first use. Returns false (and
+    // changes nothing) once global() has been called.
+    static bool configureGlobal(size_t workerCount, bool pinWorkers);
+
+    size_t getWorkerCount() const;
+
+    // Workers plus the thread calling parallelFor()
+    size_t getConcurrency() const;
+
+    // Queue a task; it must not throw
+    void submit(std::function<void()> task);
+
+    // Run one queued task on the calling thread; false if there was none
+    bool runPendingTask();
+
+    // body(rangeBegin, rangeEnd) over [begin, end) in pieces of at most `grain`
+    // indices, in parallel; returns when all pieces are done and rethrows the
+    // first exception a piece threw
+    template <typename Body>
+    void parallelFor(size_t begin, size_t end, size_t grain, Body&& body) {
+        if (begin >= end) {
+            return;
+        }
+        grain = grain > 0 ? grain : 1;
+        if (end - begin <= grain || workers.empty()) {
+            body(begin, end);
+            return;
+        }
+
+        RangeState state(end - begin);
+        std::function<void(size_t, size_t)> run = [&](size_t first, size_t last) {
+            // Hand the right halves to thieves, keep the left
+            while (last - first > grain) {
+                size_t middle = first + (last - first) / 2;
+                push({[&run, middle, last] { run(middle, last); }, &state});
+                last = middle;
+            }
+            try {
+                body(first, last);
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+            state.finish(last - first);
+        };
+
+        run(begin, end);
+        waitForRange(state);
+
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+    }
+};
+
+#endif // THREAD_POOL_H
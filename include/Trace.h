@@ -0,0 +1,74 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Lightweight tracing of hot paths, exportable as Chrome trace JSON
+// (load in chrome://tracing or https://ui.perfetto.dev).
+//
+// Spans are recorded with the NN_TRACE_SCOPE macros, which compile to nothing
+// unless NN_ENABLE_TRACING is defined (CMake option ENABLE_TRACING). Each
+// thread appends to its own buffer, so recording takes no locks; the buffers
+// are only walked when the trace is exported.
+
+class Tracer {
+public:
+    // One completed span
+    struct Event {
+        const char* name;           // Must be a string literal (not copied)
+        const char* argName;        // Optional argument name (nullptr if none)
+        int64_t argValue;
+        int64_t startNs;            // Relative to the tracer's epoch
+        int64_t durationNs;
+    };
+
+    // Records a span from construction to destruction
+    class Scope {
+    private:
+        const char* name;
+        const char* argName;
+        int64_t argValue;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit Scope(const char* spanName, const char* spanArgName = nullptr, int64_t spanArgValue = 0);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Maximum events kept per thread; later events are dropped (and counted)
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+    // Append a completed span to the calling thread's buffer
+    static void record(const char* name, const char* argName, int64_t argValue,
+                       std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end);
+
+    // Write all recorded spans as Chrome trace JSON; returns false if the file can't be written
+    static bool writeChromeTrace(const std::string& path);
+
+    // Discard all recorded spans
+    static void clear();
+
+    // Number of recorded (and dropped) spans across all threads
+    static size_t getEventCount();
+    static size_t getDroppedCount();
+};
+
+#ifdef NN_ENABLE_TRACING
+#define NN_TRACE_CONCAT_INNER(a, b) a##b
+#define NN_TRACE_CONCAT(a, b) NN_TRACE_CONCAT_INNER(a, b)
+#define NN_TRACE_SCOPE(name) Tracer::Scope NN_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define NN_TRACE_SCOPE_ARG(name, argName, argValue) \
+    Tracer::Scope NN_TRACE_CONCAT(traceScope_, __LINE__)(name, argName, static_cast<int64_t>(argValue))
+#else
+#define NN_TRACE_SCOPE(name) ((void)0)
+#define NN_TRACE_SCOPE_ARG(name, argName, argValue) ((void)0)
+#endif
+
+#endif // TRACE_H
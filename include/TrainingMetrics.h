@@ -0,0 +1,19 @@
+#ifndef TRAINING_METRICS_H
+#define TRAINING_METRICS_H
+
+#include <cstddef>
+#include "RingBuffer.h"
+
+// Metrics for one training batch, published by Network::train
+struct BatchMetrics {
+    int epoch = 0;                  // Zero-based epoch index
+    size_t batch = 0;               // Batch index since training started
+    double loss = 0.0;              // Average cross-entropy loss over the batch
+    double accuracy = 0.0;          // Fraction of the batch classified correctly (before the update)
+    double samplesPerSecond = 0.0;  // Training throughput for this batch
+};
+
+// Buffer the trainer pushes batch metrics into and the GUI drains
+using TrainingMetricsBuffer = SpscRingBuffer<BatchMetrics, 4096>;
+
+#endif // TRAINING_METRICS_H
@@ -0,0 +1,84 @@
+#ifndef WEIGHT_SNAPSHOT_H
+#define WEIGHT_SNAPSHOT_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Layer.h"
+
+// Immutable copy of a network's layers that readers can run inference on
+// while training keeps updating the live network
+struct NetworkSnapshot {
+    std::vector<Layer> layers;
+    uint64_t version = 0;       // Increases with every publish
+
+    // Activations for all layers (same layout as Network::getAllActivations)
+    std::vector<std::vector<double>> getAllActivations(const std::vector<double>& input) const;
+
+    // Predict the digit for a single input
+    int predict(const std::vector<double>& input) const;
+};
+
+// Cost of publishing snapshots, for checking the overhead on the training loop
+struct SnapshotPublishStats {
+    size_t publishCount = 0;
+    size_t skippedCount = 0;            // publishIfDue() calls that didn't publish
+    double totalPublishSeconds = 0.0;
+    double maxPublishSeconds = 0.0;
+    double overheadFraction = 0.0;      // Publish time / wall time since the first publishIfDue()
+};
+
+// Publishes weight snapshots from the trainer to any number of readers.
+//
+// Readers call acquire() and keep the returned pointer for as long as they
+// need a consistent model; they never block the trainer and never see a
+// half-written snapshot. The trainer double-buffers: it copies the weights
+// into the spare snapshot (reusing its memory once no reader holds it) and
+// swaps it in with an atomic pointer store.
+//
+// publishIfDue() bounds the cost to the training loop: it publishes at most
+// once per minimum interval, and only while total publish time stays under
+// the given fraction of the elapsed training time.
+class SnapshotPublisher {
+private:
+    std::shared_ptr<const NetworkSnapshot> current;   // Accessed only through std::atomic_load/store
+    std::shared_ptr<NetworkSnapshot> spare;           // Previous snapshot, reused when no reader holds it
+    uint64_t nextVersion;
+
+    // Publish policy
+    std::chrono::steady_clock::duration minInterval;
+    double maxOverheadFraction;
+
+    // Cost accounting (trainer thread only)
+    bool started;
+    std::chrono::steady_clock::time_point firstCall;
+    std::chrono::steady_clock::time_point lastPublish;
+    SnapshotPublishStats stats;
+
+public:
+    // Constructor
+    SnapshotPublisher(std::chrono::milliseconds minPublishInterval = std::chrono::milliseconds(100),
+                      double maxOverhead = 0.02);
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Publish a snapshot of the layers now (single writer at a time)
+    void publish(const std::vector<Layer>& layers);
+
+    // Publish if the interval has passed and the overhead budget allows; returns true if published
+    bool publishIfDue(const std::vector<Layer>& layers);
+
+    // Latest published snapshot (nullptr before the first publish); safe from any thread
+    std::shared_ptr<const NetworkSnapshot> acquire() const;
+
+    // Publish cost so far
+    SnapshotPublishStats getStats() const;
+
+    // Reset cost accounting (e.g. at the start of a training run)
+    void resetStats();
+};
+
+#endif // WEIGHT_SNAPSHOT_H
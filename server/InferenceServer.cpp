@@ -0,0 +1,250 @@
+#include "InferenceServer.h"
+#include "Telemetry.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace {
+    constexpr int LISTEN_BACKLOG = 128;
+    constexpr int ACCEPT_POLL_MS = 100;     // How often run() checks for stop()
+
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = MSG_DONTWAIT;    // SIGPIPE is ignored by the server's main()
+#endif
+
+    // Write a whole message without blocking; false if the socket couldn't take all of it
+    bool sendWithoutBlocking(int fd, const void* buffer, size_t size) {
+        while (true) {
+            ssize_t count = ::send(fd, buffer, size, SEND_FLAGS);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            return count == static_cast<ssize_t>(size);
+        }
+    }
+}
+
+InferenceServer::Connection::~Connection() {
+    ::close(fd);
+}
+
+InferenceServer::InferenceServer(const InferenceModel& servedModel, const ServerConfig& serverConfig)
+    : model(servedModel), config(serverConfig), listenFd(-1), stopping(false), latencies(LATENCY_WINDOW, 0.0), nextLatency(0) {
+    if (model.getInputSize() != Protocol::IMAGE_BYTES || model.getOutputSize() != Protocol::CLASS_COUNT) {
+        throw std::runtime_error("Served model must map 784 pixels to 10 classes");
+    }
+    if (config.maxBatchSize == 0) {
+        throw std::runtime_error("Maximum batch size must be at least 1");
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (config.socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + config.socketPath);
+    }
+    std::strncpy(address.sun_path, config.socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        throw std::runtime_error("Could not create socket");
+    }
+
+    // A socket file left by a previous run would make bind() fail
+    ::unlink(config.socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(listenFd, LISTEN_BACKLOG) < 0) {
+        ::close(listenFd);
+        throw std::runtime_error("Could not listen on " + config.socketPath + ": " + std::strerror(errno));
+    }
+}
+
+InferenceServer::~InferenceServer() {
+    ::close(listenFd);
+    ::unlink(config.socketPath.c_str());
+}
+
+void InferenceServer::run() {
+    std::thread batcher(&InferenceServer::processBatches, this);
+
+    while (!stopping) {
+        reapFinishedReaders();
+
+        pollfd listener{listenFd, POLLIN, 0};
+        if (::poll(&listener, 1, ACCEPT_POLL_MS) <= 0) {
+            continue;
+        }
+
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        auto connection = std::make_shared<Connection>(fd);
+        Reader& reader = readers.emplace_back();
+        reader.connection = connection;
+        reader.thread = std::thread(&InferenceServer::readRequests, this, connection, std::ref(reader.finished));
+    }
+
+    // Unblock readers waiting on their sockets, then drain
+    for (auto& reader : readers) {
+        if (auto connection = reader.connection.lock()) {
+            ::shutdown(connection->fd, SHUT_RDWR);
+        }
+    }
+    for (auto& reader : readers) {
+        reader.thread.join();
+    }
+    readers.clear();
+    queueReady.notify_all();
+    batcher.join();
+}
+
+void InferenceServer::stop() {
+    {
+        // Under the lock so the batching thread can't miss the wakeup
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+}
+
+void InferenceServer::reapFinishedReaders() {
+    for (auto reader = readers.begin(); reader != readers.end();) {
+        if (reader->finished.load(std::memory_order_acquire)) {
+            reader->thread.join();
+            reader = readers.erase(reader);
+        } else {
+            ++reader;
+        }
+    }
+}
+
+void InferenceServer::readRequests(std::shared_ptr<Connection> connection, std::atomic<bool>& finished) {
+    while (!stopping) {
+        PendingRequest request;
+        if (!Protocol::readFully(connection->fd, request.pixels.data(), request.pixels.size())) {
+            break;
+        }
+        request.connection = connection;
+        request.received = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(std::move(request));
+        }
+        queueReady.notify_one();
+    }
+
+    // Queued requests keep the connection open until they are answered
+    connection.reset();
+    finished.store(true, std::memory_order_release);
+}
+
+void InferenceServer::processBatches() {
+    std::vector<PendingRequest> batch;
+    std::vector<double> inputs;
+    std::vector<double> outputs;
+
+    while (true) {
+        size_t depth;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+
+            // Let the batch fill, but never hold the oldest request past its deadline
+            auto deadline = queue.front().received + config.maxBatchDelay;
+            queueReady.wait_until(lock, deadline, [this] {
+                return stopping || queue.size() >= config.maxBatchSize;
+            });
+
+            depth = queue.size();
+            size_t count = std::min(depth, config.maxBatchSize);
+            std::move(queue.begin(), queue.begin() + count, std::back_inserter(batch));
+            queue.erase(queue.begin(), queue.begin() + count);
+        }
+
+        // Same scaling as Network::loadMNISTData
+        inputs.resize(batch.size() * Protocol::IMAGE_BYTES);
+        for (size_t s = 0; s < batch.size(); s++) {
+            for (size_t i = 0; i < Protocol::IMAGE_BYTES; i++) {
+                inputs[s * Protocol::IMAGE_BYTES + i] = batch[s].pixels[i] / 255.0;
+            }
+        }
+        outputs.resize(batch.size() * Protocol::CLASS_COUNT);
+        model.inferBatch(inputs.data(), batch.size(), outputs.data());
+
+        size_t dropped = 0;
+        for (size_t s = 0; s < batch.size(); s++) {
+            Connection& connection = *batch[s].connection;
+            if (connection.dropped) {
+                continue;
+            }
+
+            const double* probabilities = outputs.data() + s * Protocol::CLASS_COUNT;
+            Protocol::Response response;
+            response.predictedClass = static_cast<int32_t>(
+                std::max_element(probabilities, probabilities + Protocol::CLASS_COUNT) - probabilities);
+            for (size_t c = 0; c < Protocol::CLASS_COUNT; c++) {
+                response.probabilities[c] = static_cast<float>(probabilities[c]);
+            }
+
+            // A client that hung up or stopped reading is disconnected (which also ends its
+            // reader); a partly written response would corrupt the stream anyway
+            if (!sendWithoutBlocking(connection.fd, &response, sizeof(response))) {
+                connection.dropped = true;
+                ::shutdown(connection.fd, SHUT_RDWR);
+                dropped++;
+            }
+        }
+
+        recordBatch(batch, depth, dropped);
+        batch.clear();
+    }
+}
+
+void InferenceServer::recordBatch(const std::vector<PendingRequest>& batch, size_t depthBefore, size_t dropped) {
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for (const auto& request : batch) {
+        latencies[nextLatency % LATENCY_WINDOW] = std::chrono::duration<double, std::milli>(now - request.received).count();
+        nextLatency++;
+    }
+    stats.requests += batch.size();
+    stats.batches++;
+    stats.droppedConnections += dropped;
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, depthBefore);
+}
+
+ServerStats InferenceServer::getStats() const {
+    std::vector<double> recent;
+    ServerStats result;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        result = stats;
+        recent.assign(latencies.begin(), latencies.begin() + std::min(nextLatency, LATENCY_WINDOW));
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        result.queueDepth = queue.size();
+    }
+
+    if (result.batches > 0) {
+        result.meanBatchSize = static_cast<double>(result.requests) / result.batches;
+    }
+    if (!recent.empty()) {
+        result.latencyP50Ms = Telemetry::percentile(recent, 50.0);
+        result.latencyP99Ms = Telemetry::percentile(recent, 99.0);
+    }
+    return result;
+}
@@ -0,0 +1,115 @@
+#ifndef INFERENCE_SERVER_H
+#define INFERENCE_SERVER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "InferenceModel.h"
+#include "Protocol.h"
+
+struct ServerConfig {
+    std::string socketPath = Protocol::DEFAULT_SOCKET_PATH;
+    size_t maxBatchSize = 32;
+    std::chrono::microseconds maxBatchDelay{500};   // Longest a request waits for its batch to fill
+};
+
+// Counters since the server started; latencies cover the most recent requests
+struct ServerStats {
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    uint64_t droppedConnections = 0;    // Closed because a response couldn't be written at once
+    size_t queueDepth = 0;              // Requests waiting right now
+    size_t maxQueueDepth = 0;
+    double meanBatchSize = 0.0;
+    double latencyP50Ms = 0.0;          // From the request being read to its response being written
+    double latencyP99Ms = 0.0;
+};
+
+// Serves a model to other processes over a Unix domain socket (see Protocol.h).
+//
+// One thread per connection reads requests into a shared queue; it is joined
+// and dropped soon after its client disconnects. A single
+// batching thread waits until maxBatchSize requests are queued or the oldest
+// has waited maxBatchDelay, runs them through InferenceModel::inferBatch in
+// one pass and writes the responses without blocking: a client whose socket
+// buffer is full (it stopped reading) is disconnected rather than allowed to
+// stall every other client. Under light load requests go out almost
+// alone; under heavy load batches fill up and each weight row is reused
+// across more samples.
+class InferenceServer {
+private:
+    // Closes its socket once neither the reader nor a queued request holds it
+    struct Connection {
+        int fd;
+        bool dropped = false;           // A response didn't fit; only the batching thread uses this
+        explicit Connection(int socket) : fd(socket) {}
+        ~Connection();
+    };
+
+    // A connection's reader thread; `finished` is set as its last action, so the
+    // accept loop can join it without waiting
+    struct Reader {
+        std::thread thread;
+        std::weak_ptr<Connection> connection;
+        std::atomic<bool> finished{false};
+    };
+
+    struct PendingRequest {
+        std::shared_ptr<Connection> connection;
+        std::array<uint8_t, Protocol::IMAGE_BYTES> pixels;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    static constexpr size_t LATENCY_WINDOW = 10000;
+
+    const InferenceModel& model;
+    ServerConfig config;
+    int listenFd;
+    std::atomic<bool> stopping;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<PendingRequest> queue;
+
+    std::list<Reader> readers;          // Only touched by run(); nodes stay put for their threads
+
+    mutable std::mutex statsMutex;
+    ServerStats stats;
+    std::vector<double> latencies;      // Ring of the last LATENCY_WINDOW latencies, in ms
+    size_t nextLatency;
+
+    void readRequests(std::shared_ptr<Connection> connection, std::atomic<bool>& finished);
+
+    // Join and forget readers whose client has disconnected
+    void reapFinishedReaders();
+    void processBatches();
+    void recordBatch(const std::vector<PendingRequest>& batch, size_t depthBefore, size_t dropped);
+
+public:
+    // Bind and listen on config.socketPath (replacing a stale socket file);
+    // throws std::runtime_error on failure. The model must outlive the server.
+    InferenceServer(const InferenceModel& model, const ServerConfig& config);
+    ~InferenceServer();
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    // Accept and serve connections until stop() is called
+    void run();
+
+    // Ask run() to return; safe to call from another thread
+    void stop();
+
+    ServerStats getStats() const;
+};
+
+#endif // INFERENCE_SERVER_H
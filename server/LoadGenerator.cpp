@@ -0,0 +1,154 @@
+#include "Protocol.h"
+#include "Network.h"
+#include "Telemetry.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifndef NN_DATA_DIR
+#define NN_DATA_DIR "data"
+#endif
+
+// Closed-loop load: each client keeps one request in flight on its own
+// connection, so the number of clients sets the offered concurrency.
+namespace {
+    struct ClientResult {
+        std::vector<double> latenciesMs;
+        size_t correct = 0;
+        bool failed = false;
+    };
+
+    int connectTo(const std::string& socketPath) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    void runClient(const std::string& socketPath, const std::vector<std::vector<uint8_t>>& images,
+                   const std::vector<int>& labels, size_t offset, size_t requests, ClientResult& result) {
+        int fd = connectTo(socketPath);
+        if (fd < 0) {
+            result.failed = true;
+            return;
+        }
+
+        result.latenciesMs.reserve(requests);
+        for (size_t r = 0; r < requests; r++) {
+            size_t sample = (offset + r) % images.size();
+            Protocol::Response response;
+
+            auto start = std::chrono::steady_clock::now();
+            if (!Protocol::writeFully(fd, images[sample].data(), Protocol::IMAGE_BYTES)
+                || !Protocol::readFully(fd, &response, sizeof(response))) {
+                result.failed = true;
+                break;
+            }
+            result.latenciesMs.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            result.correct += (response.predictedClass == labels[sample]);
+        }
+
+        ::close(fd);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string socketPath = Protocol::DEFAULT_SOCKET_PATH;
+    std::string dataDir = NN_DATA_DIR;
+    size_t clients = 8;
+    size_t requestsPerClient = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto valueOf = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+        try {
+            if (arg.rfind("--socket=", 0) == 0) {
+                socketPath = valueOf("--socket=");
+            } else if (arg.rfind("--clients=", 0) == 0) {
+                clients = std::stoul(valueOf("--clients="));
+            } else if (arg.rfind("--requests=", 0) == 0) {
+                requestsPerClient = std::stoul(valueOf("--requests="));
+            } else if (arg.rfind("--data-dir=", 0) == 0) {
+                dataDir = valueOf("--data-dir=");
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Unknown or invalid argument: " << arg << "\n"
+                      << "Usage: " << argv[0] << " [--socket=path] [--clients=n] [--requests=n-per-client]"
+                      << " [--data-dir=path]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Test images back as raw pixels, as a client would send them
+    Network loader;
+    auto [inputs, targets] = loader.loadMNISTData(dataDir + "/mnist_data_test.csv");
+    if (inputs.empty()) {
+        std::cerr << "No test images loaded" << std::endl;
+        return 1;
+    }
+    std::vector<std::vector<uint8_t>> images;
+    std::vector<int> labels;
+    for (size_t s = 0; s < inputs.size(); s++) {
+        std::vector<uint8_t> pixels(Protocol::IMAGE_BYTES);
+        for (size_t i = 0; i < Protocol::IMAGE_BYTES; i++) {
+            pixels[i] = static_cast<uint8_t>(std::lround(inputs[s][i] * 255.0));
+        }
+        images.push_back(std::move(pixels));
+        labels.push_back(loader.getMaxOutputIndex(targets[s]));
+    }
+
+    std::vector<ClientResult> results(clients);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < clients; c++) {
+        threads.emplace_back(runClient, std::cref(socketPath), std::cref(images), std::cref(labels),
+                             c * requestsPerClient, requestsPerClient, std::ref(results[c]));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latencies;
+    size_t correct = 0;
+    size_t failedClients = 0;
+    for (const auto& result : results) {
+        latencies.insert(latencies.end(), result.latenciesMs.begin(), result.latenciesMs.end());
+        correct += result.correct;
+        failedClients += result.failed;
+    }
+    if (latencies.empty()) {
+        std::cerr << "No responses from " << socketPath << std::endl;
+        return 1;
+    }
+
+    size_t completed = latencies.size();
+    std::cout << completed << " requests from " << clients << " clients in " << seconds << " s: "
+              << completed / seconds << " requests/s, p50 " << Telemetry::percentile(latencies, 50.0)
+              << " ms, p99 " << Telemetry::percentile(latencies, 99.0) << " ms, accuracy "
+              << 100.0 * correct / completed << "%" << std::endl;
+    if (failedClients > 0) {
+        std::cerr << failedClients << " clients lost their connection" << std::endl;
+        return 1;
+    }
+    return 0;
+}
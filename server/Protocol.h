@@ -0,0 +1,63 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <unistd.h>
+
+// Wire format between the inference server and its clients, over a Unix
+// domain stream socket. Both ends run on the same machine, so values use the
+// native byte order.
+//
+//   request:  IMAGE_BYTES raw 0-255 pixels, row by row
+//   response: Response (predicted class, then one probability per class)
+//
+// A connection carries any number of requests; responses come back in the
+// order the requests were sent.
+namespace Protocol {
+    constexpr size_t IMAGE_BYTES = 784;
+    constexpr size_t CLASS_COUNT = 10;
+    constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/nn_inference.sock";
+
+    struct Response {
+        int32_t predictedClass;
+        float probabilities[CLASS_COUNT];
+    };
+
+    // Read exactly `size` bytes; false on end of stream or error
+    inline bool readFully(int fd, void* buffer, size_t size) {
+        uint8_t* bytes = static_cast<uint8_t*>(buffer);
+        while (size > 0) {
+            ssize_t count = ::read(fd, bytes, size);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    // Write exactly `size` bytes; false on error
+    inline bool writeFully(int fd, const void* buffer, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+        while (size > 0) {
+            ssize_t count = ::write(fd, bytes, size);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            bytes += count;
+            size -= static_cast<size_t>(count);
+        }
+        return true;
+    }
+}
+
+#endif // PROTOCOL_H
@@ -0,0 +1,89 @@
+#include "InferenceServer.h"
+#include "Network.h"
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifndef NN_DATA_DIR
+#define NN_DATA_DIR "data"
+#endif
+
+namespace {
+    std::atomic<bool> interrupted(false);
+
+    void onSignal(int) {
+        interrupted = true;
+    }
+}
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    std::string dataDir = NN_DATA_DIR;
+    int epochs = 5;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto valueOf = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+        try {
+            if (arg.rfind("--socket=", 0) == 0) {
+                config.socketPath = valueOf("--socket=");
+            } else if (arg.rfind("--max-batch=", 0) == 0) {
+                config.maxBatchSize = std::stoul(valueOf("--max-batch="));
+            } else if (arg.rfind("--max-delay-us=", 0) == 0) {
+                config.maxBatchDelay = std::chrono::microseconds(std::stol(valueOf("--max-delay-us=")));
+            } else if (arg.rfind("--epochs=", 0) == 0) {
+                epochs = std::stoi(valueOf("--epochs="));
+            } else if (arg.rfind("--data-dir=", 0) == 0) {
+                dataDir = valueOf("--data-dir=");
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Unknown or invalid argument: " << arg << "\n"
+                      << "Usage: " << argv[0] << " [--socket=path] [--max-batch=n] [--max-delay-us=n]"
+                      << " [--epochs=n] [--data-dir=path]" << std::endl;
+            return 1;
+        }
+    }
+
+    // The network has no file format, so train the served model at startup
+    Network network(0.01);
+    network.addLayer(128, ActivationType::RELU);
+    network.addLayer(10, ActivationType::SOFTMAX);
+    network.train(dataDir + "/mnist_data_train.csv", epochs, 10);
+
+    // Clients that disconnect mid-response must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    try {
+        InferenceServer server(network, config);
+        std::thread serving(&InferenceServer::run, &server);
+        std::cout << "Serving on " << config.socketPath << " (batches of up to " << config.maxBatchSize
+                  << ", max delay " << config.maxBatchDelay.count() << " us)" << std::endl;
+
+        // Print statistics once a second while requests are coming in
+        uint64_t lastRequests = 0;
+        while (!interrupted) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            ServerStats stats = server.getStats();
+            if (stats.requests != lastRequests) {
+                std::cout << "Requests: " << stats.requests << ", queue depth: " << stats.queueDepth
+                          << " (max " << stats.maxQueueDepth << "), mean batch: " << stats.meanBatchSize
+                          << ", p50: " << stats.latencyP50Ms << " ms, p99: " << stats.latencyP99Ms << " ms"
+                          << ", dropped connections: " << stats.droppedConnections << std::endl;
+                lastRequests = stats.requests;
+            }
+        }
+
+        server.stop();
+        serving.join();
+    } catch (const std::exception& e) {
+        std::cerr << "Server error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "../include/Activation.h"
+#include "../include/Softmax.h"
+#include <stdexcept>
+
+namespace {
+    constexpr double GELU_SCALE = 0.7978845608028654;   // sqrt(2 / pi)
+    constexpr double GELU_CUBIC = 0.044715;
+
+    // tanh of each value in place, from exp(2v)
+    void tanhInPlace(double* values, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            values[i] *= 2.0;
+        }
+        Softmax::fastExp(values, n);
+        for (size_t i = 0; i < n; i++) {
+            values[i] = 1.0 - 2.0 / (values[i] + 1.0);
+        }
+    }
+
+    // Inner argument of the GELU tanh approximation
+    double geluInner(double x) {
+        return GELU_SCALE * (x + GELU_CUBIC * x * x * x);
+    }
+}
+
+void Activation::Tanh::apply(const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = x[i];
+    }
+    tanhInPlace(y, n);
+}
+
+void Activation::Tanh::derivative(const double*, const double* y, double* d, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        d[i] = 1.0 - y[i] * y[i];
+    }
+}
+
+void Activation::Sigmoid::apply(const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = -x[i];
+    }
+    Softmax::fastExp(y, n);
+    for (size_t i = 0; i < n; i++) {
+        y[i] = 1.0 / (1.0 + y[i]);
+    }
+}
+
+void Activation::Sigmoid::derivative(const double*, const double* y, double* d, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        d[i] = y[i] * (1.0 - y[i]);
+    }
+}
+
+void Activation::Gelu::apply(const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        y[i] = geluInner(x[i]);
+    }
+    tanhInPlace(y, n);
+    for (size_t i = 0; i < n; i++) {
+        y[i] = 0.5 * x[i] * (1.0 + y[i]);
+    }
+}
+
+void Activation::Gelu::derivative(const double* x, const double*, double* d, size_t n) {
+    // Not expressible from the output alone: recompute t = tanh(inner(x))
+    for (size_t i = 0; i < n; i++) {
+        d[i] = geluInner(x[i]);
+    }
+    tanhInPlace(d, n);
+    for (size_t i = 0; i < n; i++) {
+        double t = d[i];
+        double innerDerivative = GELU_SCALE * (1.0 + 3.0 * GELU_CUBIC * x[i] * x[i]);
+        d[i] = 0.5 * (1.0 + t) + 0.5 * x[i] * (1.0 - t * t) * innerDerivative;
+    }
+}
+
+void Activation::apply(ActivationType type, const double* x, double* y, size_t n) {
+    switch (type) {
+        case ActivationType::RELU:       Relu::apply(x, y, n); break;
+        case ActivationType::LEAKY_RELU: LeakyRelu::apply(x, y, n); break;
+        case ActivationType::TANH:       Tanh::apply(x, y, n); break;
+        case ActivationType::SIGMOID:    Sigmoid::apply(x, y, n); break;
+        case ActivationType::GELU:       Gelu::apply(x, y, n); break;
+        case ActivationType::SOFTMAX:    Identity::apply(x, y, n); break;
+        default:
+            throw std::runtime_error("Unknown activation type");
+    }
+}
+
+void Activation::derivative(ActivationType type, const double* x, const double* y, double* d, size_t n) {
+    switch (type) {
+        case ActivationType::RELU:       Relu::derivative(x, y, d, n); break;
+        case ActivationType::LEAKY_RELU: LeakyRelu::derivative(x, y, d, n); break;
+        case ActivationType::TANH:       Tanh::derivative(x, y, d, n); break;
+        case ActivationType::SIGMOID:    Sigmoid::derivative(x, y, d, n); break;
+        case ActivationType::GELU:       Gelu::derivative(x, y, d, n); break;
+        case ActivationType::SOFTMAX:    Identity::derivative(x, y, d, n); break;
+        default:
+            throw std::runtime_error("Unknown activation type");
+    }
+}
@@ -0,0 +1,156 @@
+#include "../include/Telemetry.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+// Replaces the global operator new/delete to count heap allocations. Only built
+// with the CMake option ENABLE_ALLOCATION_COUNTING, since it changes allocation
+// for every binary that links the core library.
+
+namespace {
+    // One per allocating thread. Only the owning thread writes it, so counting
+    // never touches a cache line shared with other threads; readers sum them.
+    struct ThreadCounters {
+        std::atomic<size_t> count{0};
+        std::atomic<size_t> bytes{0};
+        ThreadCounters* previous = nullptr;
+        ThreadCounters* next = nullptr;
+
+        ThreadCounters();
+        ~ThreadCounters();
+    };
+
+    // Counters of the running threads, plus the totals of threads that have exited.
+    // All constant-initialized, so they work for allocations during static initialization.
+    std::mutex registryMutex;
+    ThreadCounters* runningThreads = nullptr;
+    std::atomic<size_t> exitedCount(0);
+    std::atomic<size_t> exitedBytes(0);
+
+    // Set once this thread's counters are destroyed; later allocations from other
+    // thread_local destructors go straight to the exited totals
+    thread_local bool countersDestroyed = false;
+    thread_local ThreadCounters threadCounters;
+
+    ThreadCounters::ThreadCounters() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        next = runningThreads;
+        if (next) {
+            next->previous = this;
+        }
+        runningThreads = this;
+    }
+
+    ThreadCounters::~ThreadCounters() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        exitedCount.fetch_add(count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        exitedBytes.fetch_add(bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        (previous ? previous->next : runningThreads) = next;
+        if (next) {
+            next->previous = previous;
+        }
+        countersDestroyed = true;
+    }
+
+    void recordAllocation(std::size_t size) {
+        if (countersDestroyed) {
+            exitedCount.fetch_add(1, std::memory_order_relaxed);
+            exitedBytes.fetch_add(size, std::memory_order_relaxed);
+            return;
+        }
+        ThreadCounters& counters = threadCounters;
+        counters.count.store(counters.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counters.bytes.store(counters.bytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    }
+
+    void* allocate(std::size_t size) {
+        recordAllocation(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        recordAllocation(size);
+        std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants a nonzero multiple of the alignment
+        std::size_t rounded = size > 0 ? (size + align - 1) / align * align : align;
+        return std::aligned_alloc(align, rounded);
+#endif
+    }
+
+    void freeAligned(void* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+// The array forms forward to these by default
+void* operator new(std::size_t size) {
+    if (void* ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* ptr = allocateAligned(size, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    freeAligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    freeAligned(ptr);
+}
+
+size_t Telemetry::getAllocationCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = exitedCount.load(std::memory_order_relaxed);
+    for (ThreadCounters* counters = runningThreads; counters; counters = counters->next) {
+        total += counters->count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t Telemetry::getAllocatedBytes() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = exitedBytes.load(std::memory_order_relaxed);
+    for (ThreadCounters* counters = runningThreads; counters; counters = counters->next) {
+        total += counters->bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t Telemetry::getThreadAllocationCount() {
+    return countersDestroyed ? 0 : threadCounters.count.load(std::memory_order_relaxed);
+}
+
+size_t Telemetry::getThreadAllocatedBytes() {
+    return countersDestroyed ? 0 : threadCounters.bytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,38 @@
+#include "../include/BFloat16.h"
+
+void BFloat16::fromDoubles(const double* values, uint16_t* converted, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        converted[i] = fromFloat(static_cast<float>(values[i]));
+    }
+}
+
+float BFloat16::dot(const uint16_t* weights, const float* inputs, size_t count) {
+    // Eight independent accumulators: one AVX register's worth of floats
+    constexpr size_t LANES = 8;
+    float sums[LANES] = {};
+
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t lane = 0; lane < LANES; lane++) {
+            sums[lane] += toFloat(weights[i + lane]) * inputs[i + lane];
+        }
+    }
+
+    float sum = 0.0f;
+    for (; i < count; i++) {
+        sum += toFloat(weights[i]) * inputs[i];
+    }
+    for (size_t lane = 0; lane < LANES; lane++) {
+        sum += sums[lane];
+    }
+
+    return sum;
+}
+
+float BFloat16::sparseDot(const uint16_t* weights, const double* inputs, const std::vector<size_t>& activeInputs) {
+    float sum = 0.0f;
+    for (size_t index : activeInputs) {
+        sum += toFloat(weights[index]) * static_cast<float>(inputs[index]);
+    }
+    return sum;
+}
@@ -0,0 +1,283 @@
+#include "../include/BatchScorer.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr size_t READ_BLOCK_BYTES = 1 << 20;
+    constexpr size_t WRITE_BUFFER_BYTES = 1 << 20;
+    constexpr size_t CHUNKS_PER_SLOT = 2;       // In flight per scoring slot: one being scored, one queued
+
+    using File = std::unique_ptr<FILE, int (*)(FILE*)>;
+
+    // Whole input lines, and their formatted predictions once scored
+    struct Chunk {
+        size_t sequence = 0;
+        size_t firstLine = 0;       // 1-based line number of the first line, for error messages
+        std::string text;
+        std::string output;
+        size_t samples = 0;
+    };
+
+    bool isBlank(const char* begin, const char* end) {
+        return std::all_of(begin, end, [](char c) { return c == ' ' || c == '\t' || c == '\r'; });
+    }
+
+    // Pixels of one line, scaled like Network::loadMNISTData; a leading label is skipped
+    void parseLine(const char* begin, const char* end, size_t inputSize, size_t lineNumber, double* pixels) {
+        size_t fields = 1 + std::count(begin, end, ',');
+        if (fields != inputSize && fields != inputSize + 1) {
+            throw std::runtime_error("Line " + std::to_string(lineNumber) + " has " + std::to_string(fields)
+                                     + " values, expected " + std::to_string(inputSize) + " pixels and an optional label");
+        }
+
+        const char* position = begin;
+        if (fields == inputSize + 1) {
+            position = std::find(begin, end, ',') + 1;
+        }
+        for (size_t i = 0; i < inputSize; i++) {
+            // Pixels are almost always plain integers: parse those directly, anything else with strtod
+            const char* next = position;
+            unsigned value = 0;
+            while (next < end && *next >= '0' && *next <= '9') {
+                value = value * 10 + static_cast<unsigned>(*next - '0');
+                next++;
+            }
+            if (next > position && next - position < 10 && (next == end || *next == ',' || *next == '\r')) {
+                pixels[i] = value / 255.0;
+            } else {
+                char* parsedEnd = nullptr;
+                double parsed = std::strtod(position, &parsedEnd);
+                if (parsedEnd == position || parsedEnd > end) {
+                    throw std::runtime_error("Line " + std::to_string(lineNumber) + " has a malformed value");
+                }
+                pixels[i] = parsed / 255.0;
+                next = parsedEnd;
+            }
+            position = next + 1;
+        }
+    }
+
+    // Parse, score and format one chunk into chunk.output
+    void scoreChunk(const InferenceModel& model, const ScoringOptions& options, Chunk& chunk) {
+        const size_t inputSize = model.getInputSize();
+        const size_t outputSize = model.getOutputSize();
+
+        std::vector<double> inputs;
+        const char* text = chunk.text.c_str();
+        const char* textEnd = text + chunk.text.size();
+        size_t lineNumber = chunk.firstLine;
+        for (const char* line = text; line < textEnd; lineNumber++) {
+            const char* lineEnd = std::find(line, textEnd, '\n');
+            if (!isBlank(line, lineEnd)) {
+                inputs.resize(inputs.size() + inputSize);
+                parseLine(line, lineEnd, inputSize, lineNumber, inputs.data() + inputs.size() - inputSize);
+            }
+            line = lineEnd + 1;
+        }
+        chunk.samples = inputs.size() / inputSize;
+
+        std::vector<double> outputs(chunk.samples * outputSize);
+        for (size_t start = 0; start < chunk.samples; start += options.batchSize) {
+            size_t count = std::min(options.batchSize, chunk.samples - start);
+            model.inferBatch(inputs.data() + start * inputSize, count, outputs.data() + start * outputSize);
+        }
+
+        // "class,p0,p1,..." per sample
+        char number[32];
+        chunk.output.clear();
+        chunk.output.reserve(chunk.samples * (options.writeProbabilities ? outputSize * 12 + 2 : 2));
+        for (size_t s = 0; s < chunk.samples; s++) {
+            const double* probabilities = outputs.data() + s * outputSize;
+            size_t predicted = std::max_element(probabilities, probabilities + outputSize) - probabilities;
+            chunk.output += std::to_string(predicted);
+            if (options.writeProbabilities) {
+                for (size_t o = 0; o < outputSize; o++) {
+                    int length = std::snprintf(number, sizeof(number), ",%.6g", probabilities[o]);
+                    chunk.output.append(number, static_cast<size_t>(length));
+                }
+            }
+            chunk.output += '\n';
+        }
+        chunk.text.clear();
+        chunk.text.shrink_to_fit();
+    }
+}
+
+BatchScorer::BatchScorer(const InferenceModel& scoredModel, const ScoringOptions& scoringOptions)
+    : model(scoredModel), options(scoringOptions) {
+    if (options.chunkSamples == 0 || options.batchSize == 0) {
+        throw std::runtime_error("Chunk and batch sizes must be at least 1");
+    }
+}
+
+ScoringStats BatchScorer::score(const std::string& inputPath, const std::string& outputPath) const {
+    File input(std::fopen(inputPath.c_str(), "rb"), &std::fclose);
+    if (!input) {
+        throw std::runtime_error("Could not open file: " + inputPath);
+    }
+    File output(std::fopen(outputPath.c_str(), "wb"), &std::fclose);
+    if (!output) {
+        throw std::runtime_error("Could not open file: " + outputPath);
+    }
+    std::setvbuf(output.get(), nullptr, _IOFBF, WRITE_BUFFER_BYTES);
+
+    ThreadPool& pool = ThreadPool::global();
+    const size_t slots = options.threads > 0 ? options.threads : pool.getConcurrency();
+    const size_t maxInFlight = slots * CHUNKS_PER_SLOT;
+
+    ScoringStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    // Shared between the reader (this thread), the scoring tasks and the writer
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<size_t, Chunk> scored;     // Waiting for every earlier chunk to be written
+    size_t nextToWrite = 0;
+    size_t inFlight = 0;                // Read but not yet written
+    size_t scoring = 0;                 // Submitted to the pool but not finished
+    bool doneReading = false;
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+            error = e;
+        }
+        changed.notify_all();
+    };
+
+    std::thread writer([&] {
+        while (true) {
+            Chunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] {
+                    return error || scored.count(nextToWrite) > 0 || (doneReading && inFlight == 0);
+                });
+                if (error || scored.count(nextToWrite) == 0) {
+                    return;
+                }
+                auto next = scored.find(nextToWrite);
+                chunk = std::move(next->second);
+                scored.erase(next);
+            }
+
+            if (std::fwrite(chunk.output.data(), 1, chunk.output.size(), output.get()) != chunk.output.size()) {
+                fail(std::make_exception_ptr(std::runtime_error("Could not write file: " + outputPath)));
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.samples += chunk.samples;
+            stats.bytesWritten += chunk.output.size();
+            nextToWrite++;
+            inFlight--;
+            changed.notify_all();
+        }
+    });
+
+    // Read blocks and hand out chunks of chunkSamples whole lines
+    std::string pending;
+    std::vector<char> block(READ_BLOCK_BYTES);
+    size_t scanned = 0;             // Bytes of pending already searched for newlines
+    size_t pendingLines = 0;
+    size_t nextLine = 1;
+    size_t sequence = 0;
+
+    auto submit = [&](size_t length, size_t lines) {
+        Chunk chunk;
+        chunk.sequence = sequence++;
+        chunk.firstLine = nextLine;
+        chunk.text = pending.substr(0, length);
+        pending.erase(0, length);
+        nextLine += lines;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return error || inFlight < maxInFlight; });
+            if (error) {
+                return false;
+            }
+            inFlight++;
+            scoring++;
+        }
+
+        // Runs inline when the pool has no workers, so the lock must not be held here
+        auto task = std::make_shared<Chunk>(std::move(chunk));
+        pool.submit([&, task] {
+            std::exception_ptr taskError;
+            try {
+                scoreChunk(model, options, *task);
+            } catch (...) {
+                taskError = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (taskError && !error) {
+                error = taskError;
+            } else if (!taskError) {
+                scored.emplace(task->sequence, std::move(*task));
+            }
+            scoring--;
+            changed.notify_all();
+        });
+        return true;
+    };
+
+    bool reading = true;
+    while (reading) {
+        size_t count = std::fread(block.data(), 1, block.size(), input.get());
+        stats.bytesRead += count;
+        pending.append(block.data(), count);
+
+        while (reading && scanned < pending.size()) {
+            if (pending[scanned++] == '\n' && ++pendingLines == options.chunkSamples) {
+                reading = submit(scanned, pendingLines);
+                scanned = 0;
+                pendingLines = 0;
+            }
+        }
+
+        if (reading && count < block.size()) {
+            if (std::ferror(input.get())) {
+                fail(std::make_exception_ptr(std::runtime_error("Could not read file: " + inputPath)));
+            } else if (!pending.empty()) {
+                // The remaining lines, the last possibly without a trailing newline
+                submit(pending.size(), pendingLines + (pending.back() != '\n'));
+            }
+            reading = false;
+        }
+    }
+
+    {
+        // Tasks still queued after an error refer to this frame, so wait for them too
+        std::unique_lock<std::mutex> lock(mutex);
+        doneReading = true;
+        changed.notify_all();
+        changed.wait(lock, [&] { return scoring == 0; });
+    }
+    writer.join();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (std::fflush(output.get()) != 0) {
+        throw std::runtime_error("Could not write file: " + outputPath);
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.samplesPerSecond = stats.seconds > 0.0 ? stats.samples / stats.seconds : 0.0;
+    return stats;
+}
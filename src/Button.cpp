@@ -1,4 +1,5 @@
 #include "../include/Button.h"
+#include "../include/Profiler.h"
 
 Button::Button(const sf::Vector2f& position, const sf::Vector2f& size, 
                const std::string& buttonText, const sf::Font* buttonFont, 
@@ -80,8 +81,8 @@ void Button::handleMouseRelease(const sf::Vector2i& mousePosition) {
 }
 
 void Button::draw(sf::RenderWindow& window) const {
-    window.draw(shape);
-    window.draw(text);
+    profiledDraw(window, shape);
+    profiledDraw(window, text);
 }
 
 void Button::setCallback(std::function<void()> func) {
@@ -0,0 +1,160 @@
+#include "../include/Evaluator.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr double MIN_PROBABILITY = 1e-10;   // Loss clipping, as in Network::calculateLoss
+
+    EvaluationReport emptyReport(size_t classes, size_t maxTopK) {
+        EvaluationReport report;
+        report.confusion.assign(classes, std::vector<size_t>(classes, 0));
+        report.topKCorrect.assign(maxTopK, 0);
+        return report;
+    }
+}
+
+double EvaluationReport::getAccuracy() const {
+    return getTopKAccuracy(1);
+}
+
+double EvaluationReport::getTopKAccuracy(size_t k) const {
+    if (samples == 0 || k == 0 || k > topKCorrect.size()) {
+        return 0.0;
+    }
+    return static_cast<double>(topKCorrect[k - 1]) / samples;
+}
+
+double EvaluationReport::getPrecision(size_t label) const {
+    size_t predicted = 0;
+    for (const auto& row : confusion) {
+        predicted += row[label];
+    }
+    return predicted > 0 ? static_cast<double>(confusion[label][label]) / predicted : 0.0;
+}
+
+double EvaluationReport::getRecall(size_t label) const {
+    size_t actual = 0;
+    for (size_t count : confusion[label]) {
+        actual += count;
+    }
+    return actual > 0 ? static_cast<double>(confusion[label][label]) / actual : 0.0;
+}
+
+std::string EvaluationReport::toString() const {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "Samples: " << samples << ", accuracy: " << getAccuracy() * 100.0 << "%";
+    for (size_t k = 2; k <= topKCorrect.size(); k++) {
+        ss << ", top-" << k << ": " << getTopKAccuracy(k) * 100.0 << "%";
+    }
+    ss << ", loss: " << std::setprecision(4) << loss << "\n";
+
+    ss << std::setprecision(3) << "Class  Precision  Recall\n";
+    for (size_t c = 0; c < confusion.size(); c++) {
+        ss << std::setw(5) << c << std::setw(11) << getPrecision(c) << std::setw(8) << getRecall(c) << "\n";
+    }
+
+    ss << "Confusion matrix (rows: actual, columns: predicted)\n";
+    for (const auto& row : confusion) {
+        for (size_t count : row) {
+            ss << std::setw(6) << count;
+        }
+        ss << "\n";
+    }
+    return ss.str();
+}
+
+Evaluator::Evaluator(const InferenceModel& evaluatedModel, size_t threadCount, size_t topK)
+    : model(evaluatedModel), threads(threadCount), maxTopK(std::max<size_t>(topK, 1)) {
+    if (threads == 0) {
+        threads = ThreadPool::global().getConcurrency();
+    }
+}
+
+void Evaluator::evaluateShard(const std::vector<std::vector<double>>& inputs,
+                              const std::vector<std::vector<double>>& targets,
+                              size_t begin, size_t end, EvaluationReport& report) const {
+    const size_t inputSize = model.getInputSize();
+    const size_t classes = model.getOutputSize();
+    std::vector<double> batchInputs(BATCH_SIZE * inputSize);
+    std::vector<double> batchOutputs(BATCH_SIZE * classes);
+
+    for (size_t start = begin; start < end; start += BATCH_SIZE) {
+        size_t count = std::min(BATCH_SIZE, end - start);
+        for (size_t s = 0; s < count; s++) {
+            if (inputs[start + s].size() != inputSize || targets[start + s].size() != classes) {
+                throw std::runtime_error("Sample size doesn't match the model's input or output size");
+            }
+            std::copy(inputs[start + s].begin(), inputs[start + s].end(), batchInputs.begin() + s * inputSize);
+        }
+        model.inferBatch(batchInputs.data(), count, batchOutputs.data());
+
+        for (size_t s = 0; s < count; s++) {
+            const double* outputs = batchOutputs.data() + s * classes;
+            const std::vector<double>& target = targets[start + s];
+            size_t label = std::max_element(target.begin(), target.end()) - target.begin();
+            size_t predicted = std::max_element(outputs, outputs + classes) - outputs;
+
+            // Outputs ranked above the label; it is in the top k for every k beyond that
+            size_t rank = std::count_if(outputs, outputs + classes, [&](double p) { return p > outputs[label]; });
+            for (size_t k = rank; k < maxTopK; k++) {
+                report.topKCorrect[k]++;
+            }
+
+            report.confusion[label][predicted]++;
+            for (size_t c = 0; c < classes; c++) {
+                report.loss -= target[c] * std::log(std::max(outputs[c], MIN_PROBABILITY));
+            }
+        }
+    }
+    report.samples += end - begin;
+}
+
+EvaluationReport Evaluator::evaluate(const std::vector<std::vector<double>>& inputs,
+                                     const std::vector<std::vector<double>>& targets,
+                                     int maxSamples) const {
+    if (inputs.size() != targets.size()) {
+        throw std::runtime_error("Number of inputs doesn't match number of targets");
+    }
+
+    size_t sampleCount = inputs.size();
+    if (maxSamples >= 0) {
+        sampleCount = std::min(sampleCount, static_cast<size_t>(maxSamples));
+    }
+
+    const size_t classes = model.getOutputSize();
+    const size_t batches = (sampleCount + BATCH_SIZE - 1) / BATCH_SIZE;
+    const size_t shardsWanted = threads > 1 ? threads * SHARDS_PER_THREAD : 1;
+    const size_t shardCount = std::max<size_t>(1, std::min(shardsWanted, batches));
+    std::vector<EvaluationReport> shards(shardCount, emptyReport(classes, maxTopK));
+
+    ThreadPool::global().parallelFor(0, shardCount, 1, [&](size_t begin, size_t end) {
+        for (size_t shard = begin; shard < end; shard++) {
+            evaluateShard(inputs, targets, sampleCount * shard / shardCount, sampleCount * (shard + 1) / shardCount,
+                          shards[shard]);
+        }
+    });
+
+    // Sum the shards in order
+    EvaluationReport report = emptyReport(classes, maxTopK);
+    for (const auto& shard : shards) {
+        report.samples += shard.samples;
+        report.loss += shard.loss;
+        for (size_t k = 0; k < maxTopK; k++) {
+            report.topKCorrect[k] += shard.topKCorrect[k];
+        }
+        for (size_t a = 0; a < classes; a++) {
+            for (size_t p = 0; p < classes; p++) {
+                report.confusion[a][p] += shard.confusion[a][p];
+            }
+        }
+    }
+    if (report.samples > 0) {
+        report.loss /= report.samples;
+    }
+    return report;
+}
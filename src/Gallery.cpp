@@ -0,0 +1,255 @@
+#include "../include/Gallery.h"
+#include "../include/Profiler.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const unsigned DIGIT_SIZE = 28;         // MNIST digits are 28x28 pixels
+    const size_t PREDICTION_BATCH = 64;     // Samples classified between progress updates
+}
+
+Gallery::Gallery(const sf::Vector2f& pos, const sf::Vector2f& gallerySize, const sf::Font& fontRef)
+    : position(pos), size(gallerySize), firstRow(0), images(nullptr), sampleCount(0),
+      atlasColumns(0), frameVertices(sf::Quads), tileVertices(sf::Quads), geometryDirty(true),
+      completed(0), cancelRequested(false), completedAtLastRebuild(0), correctCount(0) {
+    // Initialize visual properties (leave room for the summary line at the bottom)
+    tileSize = 40.0f;
+    tileBorder = 3.0f;
+    columns = std::max(size_t(1), static_cast<size_t>(size.x / tileSize));
+    visibleRows = std::max(size_t(1), static_cast<size_t>((size.y - 30.0f) / tileSize));
+
+    // Set colors
+    pendingColor = sf::Color(180, 180, 180);     // Gray until predicted
+    correctColor = sf::Color(60, 179, 113);      // Medium sea green
+    incorrectColor = sf::Color(220, 20, 60);     // Crimson
+
+    // Copy font reference
+    font = fontRef;
+}
+
+Gallery::~Gallery() {
+    stopPredictions();
+}
+
+void Gallery::setSamples(const std::vector<std::vector<double>>& sampleImages, const std::vector<int>& sampleLabels) {
+    stopPredictions();
+
+    images = &sampleImages;
+    labels = sampleLabels;
+
+    // Lay the digits out in a roughly square atlas that fits the GPU's texture limit
+    unsigned maxTextureSize = sf::Texture::getMaximumSize();
+    size_t maxPerSide = maxTextureSize / DIGIT_SIZE;
+    size_t count = std::min(sampleImages.size(), sampleLabels.size());
+
+    atlasColumns = std::min(maxPerSide, std::max(size_t(1),
+        static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))))));
+    size_t atlasRows = std::min(maxPerSide, (count + atlasColumns - 1) / atlasColumns);
+    sampleCount = std::min(count, atlasColumns * atlasRows);
+
+    if (sampleCount < count) {
+        std::cerr << "Gallery: atlas limited to " << sampleCount << " of " << count << " samples" << std::endl;
+    }
+
+    predictions.assign(sampleCount, -1);
+    completed.store(0);
+    completedAtLastRebuild = 0;
+    correctCount = 0;
+    firstRow = 0;
+    geometryDirty = true;
+
+    if (sampleCount == 0) {
+        return;
+    }
+
+    // Fill one RGBA buffer with every digit and upload it in a single call
+    unsigned atlasWidth = static_cast<unsigned>(atlasColumns * DIGIT_SIZE);
+    unsigned atlasHeight = static_cast<unsigned>(atlasRows * DIGIT_SIZE);
+    std::vector<sf::Uint8> pixels(static_cast<size_t>(atlasWidth) * atlasHeight * 4, 255);
+
+    for (size_t s = 0; s < sampleCount; s++) {
+        const std::vector<double>& image = sampleImages[s];
+        size_t originX = (s % atlasColumns) * DIGIT_SIZE;
+        size_t originY = (s / atlasColumns) * DIGIT_SIZE;
+        size_t pixelCount = std::min(image.size(), static_cast<size_t>(DIGIT_SIZE * DIGIT_SIZE));
+
+        for (size_t p = 0; p < pixelCount; p++) {
+            size_t x = originX + p % DIGIT_SIZE;
+            size_t y = originY + p / DIGIT_SIZE;
+            sf::Uint8 grayValue = static_cast<sf::Uint8>(image[p] * 255);
+            size_t offset = (y * atlasWidth + x) * 4;
+            pixels[offset] = grayValue;
+            pixels[offset + 1] = grayValue;
+            pixels[offset + 2] = grayValue;
+        }
+    }
+
+    if (!atlasTexture.create(atlasWidth, atlasHeight)) {
+        std::cerr << "Gallery: failed to create " << atlasWidth << "x" << atlasHeight << " atlas texture" << std::endl;
+        sampleCount = 0;
+        return;
+    }
+    atlasTexture.update(pixels.data());
+
+    std::cout << "Gallery atlas built with " << sampleCount << " samples ("
+              << atlasWidth << "x" << atlasHeight << ")" << std::endl;
+}
+
+void Gallery::startPredictions(std::shared_ptr<const NetworkSnapshot> snapshot) {
+    stopPredictions();
+
+    if (sampleCount == 0 || !snapshot || snapshot->layers.size() < 2) {
+        return;
+    }
+
+    // Reset results (the worker is stopped, so this thread owns them)
+    std::fill(predictions.begin(), predictions.end(), -1);
+    completed.store(0);
+    completedAtLastRebuild = 0;
+    correctCount = 0;
+    geometryDirty = true;
+
+    // The snapshot is immutable, so training can keep updating the network while we classify
+    cancelRequested.store(false);
+
+    worker = std::thread([this, snapshot]() {
+        for (size_t i = 0; i < sampleCount && !cancelRequested.load(std::memory_order_relaxed); i++) {
+            predictions[i] = snapshot->predict((*images)[i]);
+
+            // Publish progress in batches; release makes predictions[0..i] visible
+            if ((i + 1) % PREDICTION_BATCH == 0 || i + 1 == sampleCount) {
+                completed.store(i + 1, std::memory_order_release);
+            }
+        }
+    });
+}
+
+void Gallery::stopPredictions() {
+    if (worker.joinable()) {
+        cancelRequested.store(true);
+        worker.join();
+    }
+}
+
+void Gallery::update() {
+    size_t done = completed.load(std::memory_order_acquire);
+    if (done != completedAtLastRebuild) {
+        for (size_t i = completedAtLastRebuild; i < done; i++) {
+            if (predictions[i] == labels[i]) {
+                correctCount++;
+            }
+        }
+        completedAtLastRebuild = done;
+        geometryDirty = true;
+    }
+
+    if (geometryDirty) {
+        rebuildGeometry();
+    }
+}
+
+void Gallery::rebuildGeometry() {
+    frameVertices.clear();
+    tileVertices.clear();
+    geometryDirty = false;
+
+    size_t firstSample = firstRow * columns;
+    size_t lastSample = std::min(sampleCount, firstSample + visibleRows * columns);
+    float digitSize = static_cast<float>(DIGIT_SIZE);
+
+    for (size_t s = firstSample; s < lastSample; s++) {
+        size_t slot = s - firstSample;
+        float left = position.x + (slot % columns) * tileSize;
+        float top = position.y + (slot / columns) * tileSize;
+        float right = left + tileSize - 1.0f;
+        float bottom = top + tileSize - 1.0f;
+
+        // Frame color depends on the prediction (pending until the worker reaches it)
+        sf::Color frameColor = pendingColor;
+        if (s < completedAtLastRebuild) {
+            frameColor = (predictions[s] == labels[s]) ? correctColor : incorrectColor;
+        }
+
+        frameVertices.append(sf::Vertex(sf::Vector2f(left, top), frameColor));
+        frameVertices.append(sf::Vertex(sf::Vector2f(right, top), frameColor));
+        frameVertices.append(sf::Vertex(sf::Vector2f(right, bottom), frameColor));
+        frameVertices.append(sf::Vertex(sf::Vector2f(left, bottom), frameColor));
+
+        // Digit quad sampled from the atlas
+        float u = static_cast<float>((s % atlasColumns) * DIGIT_SIZE);
+        float v = static_cast<float>((s / atlasColumns) * DIGIT_SIZE);
+
+        tileVertices.append(sf::Vertex(sf::Vector2f(left + tileBorder, top + tileBorder),
+                                       sf::Vector2f(u, v)));
+        tileVertices.append(sf::Vertex(sf::Vector2f(right - tileBorder, top + tileBorder),
+                                       sf::Vector2f(u + digitSize, v)));
+        tileVertices.append(sf::Vertex(sf::Vector2f(right - tileBorder, bottom - tileBorder),
+                                       sf::Vector2f(u + digitSize, v + digitSize)));
+        tileVertices.append(sf::Vertex(sf::Vector2f(left + tileBorder, bottom - tileBorder),
+                                       sf::Vector2f(u, v + digitSize)));
+    }
+}
+
+void Gallery::scroll(float delta) {
+    size_t totalRows = (sampleCount + columns - 1) / columns;
+    size_t maxFirstRow = totalRows > visibleRows ? totalRows - visibleRows : 0;
+
+    long long newRow = static_cast<long long>(firstRow) - static_cast<long long>(std::round(delta));
+    newRow = std::max(0LL, std::min(static_cast<long long>(maxFirstRow), newRow));
+
+    if (static_cast<size_t>(newRow) != firstRow) {
+        firstRow = static_cast<size_t>(newRow);
+        geometryDirty = true;
+    }
+}
+
+int Gallery::getSampleIndexAt(const sf::Vector2i& mousePosition) const {
+    float x = mousePosition.x - position.x;
+    float y = mousePosition.y - position.y;
+
+    if (x < 0 || y < 0 || x >= columns * tileSize || y >= visibleRows * tileSize) {
+        return -1;
+    }
+
+    size_t index = (firstRow + static_cast<size_t>(y / tileSize)) * columns + static_cast<size_t>(x / tileSize);
+    return index < sampleCount ? static_cast<int>(index) : -1;
+}
+
+void Gallery::draw(sf::RenderWindow& window) const {
+    sf::RectangleShape background(size);
+    background.setPosition(position);
+    background.setFillColor(sf::Color(240, 240, 250));
+    profiledDraw(window, background);
+
+    profiledDraw(window, frameVertices);
+    profiledDraw(window, tileVertices, sf::RenderStates(&atlasTexture));
+
+    // Summary line below the grid
+    std::stringstream ss;
+    size_t totalRows = (sampleCount + columns - 1) / columns;
+    ss << "Rows " << std::min(firstRow + 1, totalRows) << "-" << std::min(firstRow + visibleRows, totalRows)
+       << " of " << totalRows << "   ";
+    if (completedAtLastRebuild == 0) {
+        ss << sampleCount << " samples (build and train a network to classify)";
+    } else if (completedAtLastRebuild < sampleCount) {
+        ss << "Classifying " << completedAtLastRebuild << "/" << sampleCount << "...";
+    } else {
+        ss << "Correct: " << correctCount << "/" << sampleCount << " (" << std::fixed << std::setprecision(1)
+           << (100.0 * correctCount / sampleCount) << "%)";
+    }
+
+    sf::Text summaryText;
+    summaryText.setFont(font);
+    summaryText.setString(ss.str());
+    summaryText.setCharacterSize(14);
+    summaryText.setFillColor(sf::Color(50, 50, 50));
+    summaryText.setPosition(position.x, position.y + visibleRows * tileSize + 6.0f);
+    profiledDraw(window, summaryText);
+}
+
+size_t Gallery::getSampleCount() const {
+    return sampleCount;
+}
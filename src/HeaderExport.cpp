@@ -0,0 +1,183 @@
+#include "../include/HeaderExport.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    constexpr size_t VALUES_PER_LINE = 8;
+
+    bool isIdentifier(const std::string& name) {
+        if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) {
+            return false;
+        }
+        return std::all_of(name.begin(), name.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        });
+    }
+
+    bool needsCmath(ActivationType type) {
+        return type == ActivationType::TANH || type == ActivationType::SIGMOID || type == ActivationType::GELU;
+    }
+
+    const char* activationName(ActivationType type) {
+        switch (type) {
+            case ActivationType::RELU:       return "ReLU";
+            case ActivationType::LEAKY_RELU: return "leaky ReLU";
+            case ActivationType::TANH:       return "tanh";
+            case ActivationType::SIGMOID:    return "sigmoid";
+            case ActivationType::GELU:       return "GELU";
+            case ActivationType::SOFTMAX:    return "softmax";
+        }
+        throw std::runtime_error("Unknown activation type");
+    }
+
+    // Expression for the activation of `v`, or empty for softmax (left to the argmax)
+    std::string activationExpression(ActivationType type) {
+        switch (type) {
+            case ActivationType::RELU:       return "v > 0.0 ? v : 0.0";
+            case ActivationType::LEAKY_RELU: return "v > 0.0 ? v : 0.01 * v";
+            case ActivationType::TANH:       return "std::tanh(v)";
+            case ActivationType::SIGMOID:    return "1.0 / (1.0 + std::exp(-v))";
+            case ActivationType::GELU:       return "0.5 * v * (1.0 + std::tanh(0.7978845608028654 * (v + 0.044715 * v * v * v)))";
+            case ActivationType::SOFTMAX:    return "";
+        }
+        throw std::runtime_error("Unknown activation type");
+    }
+
+    void writeArray(std::ostream& out, const std::string& name, const std::vector<double>& values) {
+        out << "alignas(64) inline constexpr double " << name << "[" << values.size() << "] = {";
+        for (size_t i = 0; i < values.size(); i++) {
+            out << (i % VALUES_PER_LINE == 0 ? "\n    " : " ") << values[i] << (i + 1 < values.size() ? "," : "");
+        }
+        out << "\n};\n\n";
+    }
+}
+
+std::string HeaderExport::generate(const std::vector<Layer>& layers, const std::string& namespaceName) {
+    if (layers.empty()) {
+        throw std::runtime_error("Cannot export a network with no layers");
+    }
+    if (!isIdentifier(namespaceName)) {
+        throw std::runtime_error("Namespace name must be a C++ identifier: " + namespaceName);
+    }
+
+    std::vector<size_t> sizes = {layers.front().getNeurons().front().getWeights().size()};
+    bool cmath = false;
+    for (const auto& layer : layers) {
+        if (layer.getNeurons().front().getWeights().size() != sizes.back()) {
+            throw std::runtime_error("Layer input size doesn't match the previous layer's output size");
+        }
+        sizes.push_back(layer.getNeurons().size());
+        cmath = cmath || needsCmath(layer.getActivationType());
+    }
+
+    std::string guard = namespaceName;
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) {
+        return static_cast<char>(std::toupper(c));
+    });
+    guard += "_H";
+
+    std::ostringstream out;
+    out.precision(std::numeric_limits<double>::max_digits10);
+
+    out << "// Generated by HeaderExport from a trained ";
+    for (size_t i = 0; i < sizes.size(); i++) {
+        out << (i > 0 ? "-" : "") << sizes[i];
+    }
+    out << " network. Do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n";
+    if (cmath) {
+        out << "#include <cmath>\n";
+    }
+    out << "\nnamespace " << namespaceName << " {\n\n"
+        << "constexpr std::size_t INPUT_SIZE = " << sizes.front() << ";\n"
+        << "constexpr std::size_t OUTPUT_SIZE = " << sizes.back() << ";\n\n";
+
+    for (size_t l = 0; l < layers.size(); l++) {
+        std::vector<double> weights;
+        std::vector<double> biases;
+        for (const auto& neuron : layers[l].getNeurons()) {
+            weights.insert(weights.end(), neuron.getWeights().begin(), neuron.getWeights().end());
+            biases.push_back(neuron.getBias());
+        }
+
+        out << "// Layer " << l << ": " << sizes[l] << " -> " << sizes[l + 1] << ", "
+            << activationName(layers[l].getActivationType()) << ", one row of " << sizes[l] << " weights per neuron\n";
+        writeArray(out, "LAYER" + std::to_string(l) + "_WEIGHTS", weights);
+        writeArray(out, "LAYER" + std::to_string(l) + "_BIASES", biases);
+    }
+
+    out << "namespace detail {\n\n"
+        << "// outputs[o] = biases[o] + row o . inputs\n"
+        << "template <std::size_t Inputs, std::size_t Outputs>\n"
+        << "inline void dense(const double* weights, const double* biases, const double* inputs, double* outputs) {\n"
+        << "    for (std::size_t o = 0; o < Outputs; o++) {\n"
+        << "        const double* row = weights + o * Inputs;\n"
+        << "        double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;\n"
+        << "        std::size_t i = 0;\n"
+        << "        for (; i + 4 <= Inputs; i += 4) {\n"
+        << "            sum0 += row[i] * inputs[i];\n"
+        << "            sum1 += row[i + 1] * inputs[i + 1];\n"
+        << "            sum2 += row[i + 2] * inputs[i + 2];\n"
+        << "            sum3 += row[i + 3] * inputs[i + 3];\n"
+        << "        }\n"
+        << "        for (; i < Inputs; i++) {\n"
+        << "            sum0 += row[i] * inputs[i];\n"
+        << "        }\n"
+        << "        outputs[o] = biases[o] + ((sum0 + sum1) + (sum2 + sum3));\n"
+        << "    }\n"
+        << "}\n\n"
+        << "} // namespace detail\n\n";
+
+    out << "// Most probable class for INPUT_SIZE raw 0-255 pixels\n"
+        << "inline int predict(const std::uint8_t* pixels) {\n"
+        << "    alignas(64) double layer0Input[INPUT_SIZE];\n"
+        << "    for (std::size_t i = 0; i < INPUT_SIZE; i++) {\n"
+        << "        layer0Input[i] = pixels[i] / 255.0;\n"
+        << "    }\n";
+    for (size_t l = 0; l < layers.size(); l++) {
+        std::string input = "layer" + std::to_string(l) + "Input";
+        std::string output = (l + 1 < layers.size()) ? "layer" + std::to_string(l + 1) + "Input" : "outputs";
+        std::string expression = activationExpression(layers[l].getActivationType());
+
+        out << "\n    alignas(64) double " << output << "[" << sizes[l + 1] << "];\n"
+            << "    detail::dense<" << sizes[l] << ", " << sizes[l + 1] << ">(LAYER" << l << "_WEIGHTS, LAYER" << l
+            << "_BIASES, " << input << ", " << output << ");\n";
+        if (!expression.empty()) {
+            out << "    for (double& v : " << output << ") {\n"
+                << "        v = " << expression << ";\n"
+                << "    }\n";
+        }
+    }
+    out << "\n    int best = 0;\n"
+        << "    for (std::size_t i = 1; i < OUTPUT_SIZE; i++) {\n"
+        << "        if (outputs[i] > outputs[best]) {\n"
+        << "            best = static_cast<int>(i);\n"
+        << "        }\n"
+        << "    }\n"
+        << "    return best;\n"
+        << "}\n\n"
+        << "} // namespace " << namespaceName << "\n\n"
+        << "#endif // " << guard << "\n";
+
+    return out.str();
+}
+
+void HeaderExport::write(const std::vector<Layer>& layers, const std::string& path, const std::string& namespaceName) {
+    std::string source = generate(layers, namespaceName);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+    file << source;
+    if (!file) {
+        throw std::runtime_error("Could not write file: " + path);
+    }
+}
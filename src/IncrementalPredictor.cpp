@@ -0,0 +1,125 @@
+#include "../include/IncrementalPredictor.h"
+#include "../include/BFloat16.h"
+
+IncrementalPredictor::IncrementalPredictor(const Network& net, size_t interval)
+    : network(net), editsSinceRefresh(0), refreshInterval(interval) {
+}
+
+void IncrementalPredictor::setInput(const std::vector<double>& input) {
+    if (network.getLayerCount() == 0) {
+        throw std::runtime_error("Network has no layers");
+    }
+    if (input.size() != network.getLayers().front().getNeurons().front().getWeights().size()) {
+        throw std::runtime_error("Input size doesn't match the network's input count");
+    }
+
+    currentInput = input;
+    refresh();
+}
+
+void IncrementalPredictor::refresh() {
+    const Layer& firstLayer = network.getLayers().front();
+
+    firstLayerSums.clear();
+    firstLayerSums.reserve(firstLayer.getNeuronCount());
+
+    if (firstLayer.getWeightPrecision() == WeightPrecision::BF16) {
+        // Same bfloat16 kernel as the layer's forward pass, so a fresh cache matches it exactly
+        const std::vector<uint16_t>& weights = firstLayer.getForwardWeights();
+        std::vector<float> floatInput(currentInput.begin(), currentInput.end());
+        for (const auto& neuron : firstLayer.getNeurons()) {
+            const uint16_t* row = weights.data() + firstLayerSums.size() * floatInput.size();
+            firstLayerSums.push_back(neuron.getBias() + BFloat16::dot(row, floatInput.data(), floatInput.size()));
+        }
+    } else {
+        for (const auto& neuron : firstLayer.getNeurons()) {
+            firstLayerSums.push_back(neuron.computeWeightedSum(currentInput));
+        }
+    }
+
+    editsSinceRefresh = 0;
+}
+
+void IncrementalPredictor::updatePixel(size_t index, double value) {
+    if (firstLayerSums.empty()) {
+        throw std::runtime_error("IncrementalPredictor has no input; call setInput first");
+    }
+    if (index >= currentInput.size()) {
+        throw std::out_of_range("Pixel index out of range");
+    }
+
+    double change = value - currentInput[index];
+    if (change == 0.0) {
+        return;
+    }
+    currentInput[index] = value;
+
+    // Rank-1 update: each first layer sum moves by weight[index] * change, using
+    // the weights the layer's forward pass reads
+    const Layer& firstLayer = network.getLayers().front();
+    const std::vector<Neuron>& neurons = firstLayer.getNeurons();
+    if (firstLayer.getWeightPrecision() == WeightPrecision::BF16) {
+        const std::vector<uint16_t>& weights = firstLayer.getForwardWeights();
+        for (size_t i = 0; i < neurons.size(); i++) {
+            firstLayerSums[i] += BFloat16::toFloat(weights[i * currentInput.size() + index]) * change;
+        }
+    } else {
+        for (size_t i = 0; i < neurons.size(); i++) {
+            firstLayerSums[i] += neurons[i].getWeights()[index] * change;
+        }
+    }
+
+    // Periodically recompute in full so floating point drift can't accumulate
+    if (++editsSinceRefresh >= refreshInterval) {
+        refresh();
+    }
+}
+
+void IncrementalPredictor::updatePixels(const std::vector<std::pair<size_t, double>>& changes) {
+    for (const auto& [index, value] : changes) {
+        updatePixel(index, value);
+    }
+}
+
+std::vector<double> IncrementalPredictor::getOutputs() const {
+    if (firstLayerSums.empty()) {
+        throw std::runtime_error("IncrementalPredictor has no input; call setInput first");
+    }
+
+    const std::vector<Layer>& layers = network.getLayers();
+
+    std::vector<double> outputs = layers.front().activateWeightedSums(firstLayerSums);
+    for (size_t i = 1; i < layers.size(); i++) {
+        outputs = layers[i].computeOutputs(outputs);
+    }
+
+    return outputs;
+}
+
+std::vector<std::vector<double>> IncrementalPredictor::getAllActivations() const {
+    if (firstLayerSums.empty()) {
+        throw std::runtime_error("IncrementalPredictor has no input; call setInput first");
+    }
+
+    const std::vector<Layer>& layers = network.getLayers();
+
+    std::vector<std::vector<double>> allActivations;
+    allActivations.reserve(layers.size() + 1);
+    allActivations.push_back(currentInput);
+
+    // First layer from the cached sums, remaining layers computed normally
+    allActivations.push_back(layers.front().activateWeightedSums(firstLayerSums));
+    for (size_t i = 1; i < layers.size(); i++) {
+        allActivations.push_back(layers[i].computeOutputs(allActivations.back()));
+    }
+
+    return allActivations;
+}
+
+int IncrementalPredictor::predict() const {
+    return network.getMaxOutputIndex(getOutputs());
+}
+
+const std::vector<double>& IncrementalPredictor::getInput() const {
+    return currentInput;
+}
@@ -0,0 +1,35 @@
+#include "../include/InferenceModel.h"
+#include <algorithm>
+#include <stdexcept>
+
+int InferenceModel::classify(const double* input) const {
+    std::vector<double> outputs(getOutputSize());
+    infer(input, outputs.data());
+    return static_cast<int>(std::distance(outputs.begin(), std::max_element(outputs.begin(), outputs.end())));
+}
+
+void InferenceModel::inferBatch(const double* inputs, size_t count, double* outputs) const {
+    const size_t inputSize = getInputSize();
+    const size_t outputSize = getOutputSize();
+    for (size_t s = 0; s < count; s++) {
+        infer(inputs + s * inputSize, outputs + s * outputSize);
+    }
+}
+
+std::vector<double> InferenceModel::infer(const std::vector<double>& input) const {
+    if (input.size() != getInputSize()) {
+        throw std::runtime_error("Input size doesn't match the model's input size");
+    }
+
+    std::vector<double> outputs(getOutputSize());
+    infer(input.data(), outputs.data());
+    return outputs;
+}
+
+int InferenceModel::classify(const std::vector<double>& input) const {
+    if (input.size() != getInputSize()) {
+        throw std::runtime_error("Input size doesn't match the model's input size");
+    }
+
+    return classify(input.data());
+}
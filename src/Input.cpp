@@ -1,4 +1,6 @@
 #include "../include/Input.h"
+#include "../include/Profiler.h"
+#include <algorithm>
 
 Input::Input(const sf::Vector2f& position, const sf::Vector2f& size) 
     : currentIndex(0), dataLoaded(false), gen(rd()) {
@@ -10,11 +12,15 @@ Input::Input(const sf::Vector2f& position, const sf::Vector2f& size)
     imageDisplay.setOutlineThickness(2);
     imageDisplay.setOutlineColor(sf::Color::Black);
     
-    // Create an empty SFML image (28x28 pixels for MNIST)
-    sfImage.create(28, 28, sf::Color::Black);
+    // Create an empty RGBA buffer and texture (28x28 pixels for MNIST)
+    pixelBuffer.assign(28 * 28 * 4, 0);
+    for (size_t i = 3; i < pixelBuffer.size(); i += 4) {
+        pixelBuffer[i] = 255; // Opaque black
+    }
     
     // Create and apply texture
-    imageTexture.loadFromImage(sfImage);
+    imageTexture.create(28, 28);
+    imageTexture.update(pixelBuffer.data());
     imageDisplay.setTexture(&imageTexture);
 }
 
@@ -89,32 +95,19 @@ void Input::updateImageDisplay() {
         return;
     }
     
-    try {
-        // Update the SFML image with current MNIST data
-        for (int y = 0; y < 28; y++) {
-            for (int x = 0; x < 28; x++) {
-                int idx = y * 28 + x;
-                
-                // Make sure we don't go out of bounds
-                if (idx < static_cast<int>(images[currentIndex].size())) {
-                    // Convert grayscale value to color
-                    unsigned char grayValue = static_cast<unsigned char>(images[currentIndex][idx] * 255);
-                    sf::Color pixelColor(grayValue, grayValue, grayValue);
-                    
-                    sfImage.setPixel(x, y, pixelColor);
-                }
-            }
-        }
-        
-        // Update the texture from the image
-        if (!imageTexture.loadFromImage(sfImage)) {
-            std::cerr << "Failed to load texture from image" << std::endl;
-        }
-        imageDisplay.setTexture(&imageTexture);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Exception in updateImageDisplay: " << e.what() << std::endl;
+    const std::vector<double>& image = images[currentIndex];
+    
+    // Convert grayscale values to RGBA in the buffer
+    size_t pixelCount = std::min(image.size(), static_cast<size_t>(28 * 28));
+    for (size_t i = 0; i < pixelCount; i++) {
+        sf::Uint8 grayValue = static_cast<sf::Uint8>(image[i] * 255);
+        pixelBuffer[i * 4] = grayValue;
+        pixelBuffer[i * 4 + 1] = grayValue;
+        pixelBuffer[i * 4 + 2] = grayValue;
     }
+    
+    // Upload the whole image to the existing texture in one call
+    imageTexture.update(pixelBuffer.data());
 }
 
 void Input::nextImage() {
@@ -145,7 +138,7 @@ void Input::randomImage() {
 }
 
 void Input::draw(sf::RenderWindow& window) const {
-    window.draw(imageDisplay);
+    profiledDraw(window, imageDisplay);
 }
 
 size_t Input::getImageCount() const {
@@ -154,4 +147,21 @@ size_t Input::getImageCount() const {
 
 bool Input::isDataLoaded() const {
     return dataLoaded;
-} 
\ No newline at end of file
+}
+
+const std::vector<std::vector<double>>& Input::getImages() const {
+    return images;
+}
+
+const std::vector<int>& Input::getLabels() const {
+    return labels;
+}
+
+void Input::setCurrentIndex(size_t index) {
+    if (!dataLoaded || index >= images.size()) {
+        return;
+    }
+    
+    currentIndex = index;
+    updateImageDisplay();
+}
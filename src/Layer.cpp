@@ -1,7 +1,33 @@
 #include "../include/Layer.h"
+#include "../include/Activation.h"
+#include "../include/BFloat16.h"
+#include "../include/Softmax.h"
+#include "../include/Trace.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    // body(begin, end) over [0, count) cut into `slices` contiguous pieces that run on
+    // the shared pool; a single call on this thread when there is nothing to split
+    template <typename Body>
+    void forEachSlice(size_t count, size_t slices, Body&& body) {
+        slices = std::min(slices, count);
+        if (slices <= 1) {
+            body(0, count);
+            return;
+        }
+        ThreadPool::global().parallelFor(0, slices, 1, [&](size_t first, size_t last) {
+            for (size_t slice = first; slice < last; slice++) {
+                body(count * slice / slices, count * (slice + 1) / slices);
+            }
+        });
+    }
+}
 
 Layer::Layer(size_t nCount, size_t inputsPerNeuron, ActivationType type) 
-    : neuronCount(nCount), activationType(type) {
+    : neuronCount(nCount), inputCount(inputsPerNeuron), activationType(type), sparseInputs(false),
+      updatedRowCount(0), skippedRowCount(0), weightPrecision(WeightPrecision::DOUBLE), partitionCount(1) {
     
     // Create the neurons
     for (size_t i = 0; i < neuronCount; i++) {
@@ -10,54 +36,274 @@ Layer::Layer(size_t nCount, size_t inputsPerNeuron, ActivationType type)
 }
 
 void Layer::forwardPropagate(const std::vector<double>& inputs) {
+    NN_TRACE_SCOPE_ARG("Layer forward", "neurons", neuronCount);
+    
     // Store inputs for later use in backpropagation
     layerInputs = inputs;
+    findActiveInputs();
     
-    // Forward propagate through each neuron
-    for (auto& neuron : neurons) {
-        neuron.computeOutput(inputs);
-    }
+    computeWeightedSums(inputs);
     
-    // If this is an output layer with softmax, apply softmax activation
+    // Run this layer's activation kernel over all the weighted sums at once
+    // (softmax normalizes across the whole layer)
+    outputValues.resize(neurons.size());
     if (activationType == ActivationType::SOFTMAX) {
-        applySoftmax();
+        outputValues = preActivations;
+        Softmax::forward(outputValues.data(), outputValues.size());
+    } else {
+        Activation::apply(activationType, preActivations.data(), outputValues.data(), outputValues.size());
+    }
+    
+    for (size_t i = 0; i < neurons.size(); i++) {
+        neurons[i].setOutput(outputValues[i]);
     }
 }
 
-void Layer::applySoftmax() {
-    // Get all outputs before softmax
-    std::vector<double> rawOutputs;
-    double maxOutput = -std::numeric_limits<double>::max();
+void Layer::computeWeightedSums(const std::vector<double>& inputs) {
+    preActivations.resize(neurons.size());
     
-    for (const auto& neuron : neurons) {
-        double output = neuron.getOutput();
-        rawOutputs.push_back(output);
+    if (weightPrecision == WeightPrecision::BF16) {
+        if (inputs.size() != inputCount) {
+            throw std::runtime_error("Input size doesn't match weights size in layer");
+        }
         
-        // Track maximum output to prevent overflow
-        if (output > maxOutput) {
-            maxOutput = output;
+        // bfloat16 weights, float accumulation
+        if (!sparseInputs) {
+            floatInputs.assign(inputs.begin(), inputs.end());
+        }
+        forEachSlice(neurons.size(), partitionCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const uint16_t* row = forwardWeights.data() + i * inputCount;
+                preActivations[i] = neurons[i].getBias() + (sparseInputs
+                    ? BFloat16::sparseDot(row, inputs.data(), activeInputs)
+                    : BFloat16::dot(row, floatInputs.data(), inputCount));
+            }
+        });
+        return;
+    }
+    
+    // Skip zero inputs when they dominate
+    forEachSlice(neurons.size(), partitionCount, [&](size_t begin, size_t end) {
+        if (sparseInputs) {
+            for (size_t i = begin; i < end; i++) {
+                preActivations[i] = neurons[i].computeWeightedSum(inputs, activeInputs);
+            }
+        } else {
+            for (size_t i = begin; i < end; i++) {
+                preActivations[i] = neurons[i].computeWeightedSum(inputs);
+            }
         }
+    });
+}
+
+void Layer::setDeltasFromWeightedSums(const std::vector<double>& sums) {
+    if (preActivations.size() != neurons.size()) {
+        throw std::runtime_error("Layer needs a forward pass before backpropagation");
+    }
+    
+    // delta = (W_next^T * deltas_next) * f'(pre-activation)
+    outputValues.resize(neurons.size());
+    gradientValues.resize(neurons.size());
+    for (size_t i = 0; i < neurons.size(); i++) {
+        outputValues[i] = neurons[i].getOutput();
     }
+    Activation::derivative(activationType, preActivations.data(), outputValues.data(), gradientValues.data(), neurons.size());
     
-    // Calculate softmax: exp(x_i - max) / sum(exp(x_j - max))
-    double sumExp = 0.0;
-    std::vector<double> expOutputs;
+    for (size_t i = 0; i < neurons.size(); i++) {
+        neurons[i].setDelta(sums[i] * gradientValues[i]);
+    }
+}
+
+void Layer::findActiveInputs() {
+    activeInputs.clear();
+    for (size_t i = 0; i < layerInputs.size(); i++) {
+        if (layerInputs[i] != 0.0) {
+            activeInputs.push_back(i);
+        }
+    }
     
-    for (double output : rawOutputs) {
-        // Subtract max for numerical stability
-        double expOutput = std::exp(output - maxOutput);
-        expOutputs.push_back(expOutput);
-        sumExp += expOutput;
+    sparseInputs = activeInputs.size() <= MAX_SPARSE_INPUT_DENSITY * layerInputs.size();
+}
+
+void Layer::applySoftmax() {
+    // Gather the weighted sums held in the neuron outputs
+    outputValues.resize(neurons.size());
+    for (size_t i = 0; i < neurons.size(); i++) {
+        outputValues[i] = neurons[i].getOutput();
     }
     
-    // Apply softmax to each neuron
+    Softmax::forward(outputValues.data(), outputValues.size());
+    
     for (size_t i = 0; i < neurons.size(); i++) {
-        double softmaxOutput = expOutputs[i] / sumExp;
-        neurons[i].setOutput(softmaxOutput);
+        neurons[i].setOutput(outputValues[i]);
+    }
+}
+
+double Layer::forwardPropagateWithLoss(const std::vector<double>& inputs, const std::vector<double>& targets) {
+    NN_TRACE_SCOPE_ARG("Layer forward+loss", "neurons", neuronCount);
+    
+    if (activationType != ActivationType::SOFTMAX) {
+        throw std::runtime_error("Fused loss kernel requires a softmax layer");
+    }
+    if (targets.size() != neurons.size()) {
+        throw std::runtime_error("Number of targets doesn't match number of output neurons");
+    }
+    
+    // Store inputs for later use in backpropagation
+    layerInputs = inputs;
+    findActiveInputs();
+    
+    computeWeightedSums(inputs);
+    outputValues = preActivations;
+    gradientValues.resize(neurons.size());
+    
+    // Softmax, loss and deltas in one pass over the cache-resident buffers
+    double loss = Softmax::forward(outputValues.data(), outputValues.size(), targets.data(), gradientValues.data());
+    
+    for (size_t i = 0; i < neurons.size(); i++) {
+        neurons[i].setOutput(outputValues[i]);
+        neurons[i].setDelta(gradientValues[i]);
+    }
+    
+    return loss;
+}
+
+std::vector<double> Layer::computeOutputs(const std::vector<double>& inputs) const {
+    std::vector<double> outputs;
+    InferenceScratch scratch;
+    computeOutputs(inputs, outputs, scratch);
+    return outputs;
+}
+
+void Layer::computeOutputs(const std::vector<double>& inputs, std::vector<double>& outputs,
+                           InferenceScratch& scratch) const {
+    if (inputs.size() != inputCount) {
+        throw std::runtime_error("Input size doesn't match weights size in layer");
+    }
+    
+    // Skip zero inputs when they dominate, as the training forward pass does (see findActiveInputs)
+    std::vector<size_t>& active = scratch.activeInputs;
+    active.clear();
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (inputs[i] != 0.0) {
+            active.push_back(i);
+        }
+    }
+    const bool sparse = active.size() <= MAX_SPARSE_INPUT_DENSITY * inputs.size();
+    
+    std::vector<double>& weightedSums = scratch.weightedSums;
+    weightedSums.resize(neurons.size());
+    
+    if (weightPrecision == WeightPrecision::BF16) {
+        // The vectorized dense bfloat16 dot product beats the gather even on sparse inputs
+        scratch.floatInputs.assign(inputs.begin(), inputs.end());
+        forEachSlice(neurons.size(), partitionCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const uint16_t* row = forwardWeights.data() + i * inputCount;
+                weightedSums[i] = neurons[i].getBias() + BFloat16::dot(row, scratch.floatInputs.data(), inputCount);
+            }
+        });
+    } else {
+        forEachSlice(neurons.size(), partitionCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                weightedSums[i] = sparse ? neurons[i].computeWeightedSum(inputs, active)
+                                         : neurons[i].computeWeightedSum(inputs);
+            }
+        });
+    }
+    
+    // Same kernels as forwardPropagate()
+    outputs.resize(neurons.size());
+    if (activationType == ActivationType::SOFTMAX) {
+        std::copy(weightedSums.begin(), weightedSums.end(), outputs.begin());
+        Softmax::forward(outputs.data(), outputs.size());
+    } else {
+        Activation::apply(activationType, weightedSums.data(), outputs.data(), outputs.size());
+    }
+}
+
+void Layer::computeOutputsBatch(const double* inputs, size_t count, double* outputs) const {
+    if (weightPrecision == WeightPrecision::BF16) {
+        for (size_t s = 0; s < count; s++) {
+            std::vector<double> sample(inputs + s * inputCount, inputs + (s + 1) * inputCount);
+            std::vector<double> sampleOutputs = computeOutputs(sample);
+            std::copy(sampleOutputs.begin(), sampleOutputs.end(), outputs + s * neuronCount);
+        }
+        return;
+    }
+    
+    // Weighted sums, four samples per pass over each weight row
+    std::vector<double> weightedSums(count * neuronCount);
+    forEachSlice(neuronCount, partitionCount, [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t n = rowBegin; n < rowEnd; n++) {
+            const double* row = neurons[n].getWeights().data();
+            const double bias = neurons[n].getBias();
+            
+            size_t s = 0;
+            for (; s + 4 <= count; s += 4) {
+                const double* x0 = inputs + s * inputCount;
+                const double* x1 = x0 + inputCount;
+                const double* x2 = x1 + inputCount;
+                const double* x3 = x2 + inputCount;
+                double sum0 = 0.0;
+                double sum1 = 0.0;
+                double sum2 = 0.0;
+                double sum3 = 0.0;
+                for (size_t i = 0; i < inputCount; i++) {
+                    sum0 += row[i] * x0[i];
+                    sum1 += row[i] * x1[i];
+                    sum2 += row[i] * x2[i];
+                    sum3 += row[i] * x3[i];
+                }
+                weightedSums[s * neuronCount + n] = bias + sum0;
+                weightedSums[(s + 1) * neuronCount + n] = bias + sum1;
+                weightedSums[(s + 2) * neuronCount + n] = bias + sum2;
+                weightedSums[(s + 3) * neuronCount + n] = bias + sum3;
+            }
+            for (; s < count; s++) {
+                const double* x = inputs + s * inputCount;
+                double sum = 0.0;
+                for (size_t i = 0; i < inputCount; i++) {
+                    sum += row[i] * x[i];
+                }
+                weightedSums[s * neuronCount + n] = bias + sum;
+            }
+        }
+    });
+
+    for (size_t s = 0; s < count; s++) {
+        const double* sums = weightedSums.data() + s * neuronCount;
+        double* sampleOutputs = outputs + s * neuronCount;
+        if (activationType == ActivationType::SOFTMAX) {
+            std::copy(sums, sums + neuronCount, sampleOutputs);
+            Softmax::forward(sampleOutputs, neuronCount);
+        } else {
+            Activation::apply(activationType, sums, sampleOutputs, neuronCount);
+        }
+    }
+}
+
+std::vector<double> Layer::activateWeightedSums(const std::vector<double>& weightedSums) const {
+    if (weightedSums.size() != neurons.size()) {
+        throw std::runtime_error("Number of weighted sums doesn't match number of neurons");
     }
+    
+    std::vector<double> outputs(weightedSums.size());
+    
+    // Same kernels as forwardPropagate()
+    if (activationType == ActivationType::SOFTMAX) {
+        outputs = weightedSums;
+        Softmax::forward(outputs.data(), outputs.size());
+    } else {
+        Activation::apply(activationType, weightedSums.data(), outputs.data(), outputs.size());
+    }
+    
+    return outputs;
 }
 
 void Layer::calculateOutputLayerDeltas(const std::vector<double>& targets) {
+    NN_TRACE_SCOPE_ARG("Layer output deltas", "neurons", neuronCount);
+    
     // Make sure we have the correct number of targets
     if (targets.size() != neurons.size()) {
         throw std::runtime_error("Number of targets doesn't match number of output neurons");
@@ -70,18 +316,156 @@ void Layer::calculateOutputLayerDeltas(const std::vector<double>& targets) {
 }
 
 void Layer::calculateHiddenLayerDeltas(const Layer& nextLayer) {
-    // For each neuron in this layer
-    for (size_t i = 0; i < neurons.size(); i++) {
-        // Calculate delta based on next layer's deltas and weights
-        neurons[i].calculateHiddenDelta(nextLayer.getNeurons(), i);
+    NN_TRACE_SCOPE_ARG("Layer backward", "neurons", neuronCount);
+    
+    const std::vector<Neuron>& nextNeurons = nextLayer.getNeurons();
+    if (!nextNeurons.empty() && nextNeurons.front().getWeights().size() != neurons.size()) {
+        throw std::runtime_error("Next layer's inputs don't match this layer's neuron count");
     }
+    
+    // sums = W_next^T * deltas_next, accumulated one contiguous weight row at a time
+    // instead of striding down a column across the next layer's neurons. Each slice
+    // of this layer sums its own columns.
+    deltaSums.assign(neurons.size(), 0.0);
+    double* sums = deltaSums.data();
+    forEachSlice(neuronCount, partitionCount, [&](size_t begin, size_t end) {
+        for (const auto& nextNeuron : nextNeurons) {
+            const double nextDelta = nextNeuron.getDelta();
+            const double* weights = nextNeuron.getWeights().data();
+            for (size_t i = begin; i < end; i++) {
+                sums[i] += nextDelta * weights[i];
+            }
+        }
+    });
+    
+    setDeltasFromWeightedSums(deltaSums);
 }
 
 void Layer::updateWeights(double learningRate) {
-    // Update weights for each neuron
-    for (auto& neuron : neurons) {
-        neuron.updateWeights(layerInputs, learningRate);
+    NN_TRACE_SCOPE_ARG("Layer update", "neurons", neuronCount);
+    
+    // Update weights for each neuron (only weights of nonzero inputs change,
+    // and neurons with a zero delta don't change at all)
+    std::atomic<size_t> skipped(0);
+    forEachSlice(neurons.size(), partitionCount, [&](size_t begin, size_t end) {
+        size_t sliceSkipped = 0;
+        for (size_t row = begin; row < end; row++) {
+            Neuron& neuron = neurons[row];
+            if (neuron.getDelta() == 0.0) {
+                sliceSkipped++;
+                continue;
+            }
+            
+            if (sparseInputs) {
+                neuron.updateWeights(layerInputs, activeInputs, learningRate);
+            } else {
+                neuron.updateWeights(layerInputs, learningRate);
+            }
+            
+            // Keep pruned weights at zero and the forward-pass copy in sync while the row is still in cache
+            if (!pruningMask.empty()) {
+                applyPruningMask(row, sparseInputs);
+            }
+            if (weightPrecision == WeightPrecision::BF16) {
+                refreshForwardWeights(row, sparseInputs);
+            }
+        }
+        skipped += sliceSkipped;
+    });
+    
+    skippedRowCount += skipped;
+    updatedRowCount += neurons.size() - skipped;
+}
+
+void Layer::propagateDeltasAndUpdateWeights(Layer& previousLayer, double learningRate) {
+    NN_TRACE_SCOPE_ARG("Layer backward+update", "neurons", neuronCount);
+    
+    if (layerInputs.size() != previousLayer.neuronCount) {
+        throw std::runtime_error("Layer inputs don't match the previous layer's neuron count");
+    }
+    
+    // Inactive ReLU units below have a zero output and a zero derivative, so their
+    // weighted delta sums aren't needed and their columns can be skipped entirely
+    bool skipInactiveInputs = sparseInputs && previousLayer.activationType == ActivationType::RELU;
+    
+    // Each neuron's weight row is read once: accumulated into W^T * deltas, then updated.
+    // Rows with a zero delta contribute nothing to either.
+    std::vector<double>& sums = previousLayer.deltaSums;
+    sums.assign(previousLayer.neuronCount, 0.0);
+    if (previousLayer.partitionCount > 1) {
+        propagateAndUpdateByColumns(previousLayer, learningRate, skipInactiveInputs);
+        previousLayer.setDeltasFromWeightedSums(sums);
+        return;
+    }
+    
+    for (size_t row = 0; row < neurons.size(); row++) {
+        Neuron& neuron = neurons[row];
+        if (neuron.getDelta() == 0.0) {
+            skippedRowCount++;
+            continue;
+        }
+        
+        if (skipInactiveInputs) {
+            neuron.propagateAndUpdateWeights(layerInputs, activeInputs, learningRate, sums.data());
+        } else {
+            neuron.propagateAndUpdateWeights(layerInputs, learningRate, sums.data());
+        }
+        updatedRowCount++;
+        
+        if (!pruningMask.empty()) {
+            applyPruningMask(row, skipInactiveInputs);
+        }
+        if (weightPrecision == WeightPrecision::BF16) {
+            refreshForwardWeights(row, skipInactiveInputs);
+        }
     }
+    
+    previousLayer.setDeltasFromWeightedSums(sums);
+}
+
+void Layer::propagateAndUpdateByColumns(Layer& previousLayer, double learningRate, bool skipInactiveInputs) {
+    // Each slice of the previous layer sweeps its own columns of every row, so it alone
+    // writes its weighted delta sums and weights, and sums rows in the same order as the
+    // unsplit sweep
+    double* sums = previousLayer.deltaSums.data();
+    forEachSlice(previousLayer.neuronCount, previousLayer.partitionCount, [&](size_t begin, size_t end) {
+        const size_t* allActive = activeInputs.data();
+        const size_t* firstActive = std::lower_bound(allActive, allActive + activeInputs.size(), begin);
+        const size_t* lastActive = std::lower_bound(firstActive, allActive + activeInputs.size(), end);
+        for (auto& neuron : neurons) {
+            if (neuron.getDelta() == 0.0) {
+                continue;
+            }
+            if (skipInactiveInputs) {
+                neuron.propagateAndUpdateWeightRange(layerInputs, firstActive, lastActive, learningRate, sums);
+            } else {
+                neuron.propagateAndUpdateWeightRange(layerInputs, begin, end, learningRate, sums);
+            }
+        }
+    });
+    
+    // Then the per-row parts: biases, pruning and the forward-pass copy
+    std::atomic<size_t> skipped(0);
+    forEachSlice(neurons.size(), previousLayer.partitionCount, [&](size_t begin, size_t end) {
+        size_t sliceSkipped = 0;
+        for (size_t row = begin; row < end; row++) {
+            if (neurons[row].getDelta() == 0.0) {
+                sliceSkipped++;
+                continue;
+            }
+            neurons[row].updateBias(learningRate);
+            if (!pruningMask.empty()) {
+                applyPruningMask(row, skipInactiveInputs);
+            }
+            if (weightPrecision == WeightPrecision::BF16) {
+                refreshForwardWeights(row, skipInactiveInputs);
+            }
+        }
+        skipped += sliceSkipped;
+    });
+    
+    skippedRowCount += skipped;
+    updatedRowCount += neurons.size() - skipped;
 }
 
 size_t Layer::getNeuronCount() const {
@@ -109,4 +493,94 @@ std::vector<double> Layer::getOutputs() const {
 
 ActivationType Layer::getActivationType() const {
     return activationType;
-} 
\ No newline at end of file
+}
+
+size_t Layer::getSkippedRowCount() const {
+    return skippedRowCount;
+}
+
+size_t Layer::getBackpropRowCount() const {
+    return updatedRowCount + skippedRowCount;
+}
+
+void Layer::resetSparsityStats() {
+    updatedRowCount = 0;
+    skippedRowCount = 0;
+}
+
+void Layer::setWeightPrecision(WeightPrecision precision) {
+    weightPrecision = precision;
+    
+    if (precision == WeightPrecision::BF16) {
+        forwardWeights.resize(neurons.size() * inputCount);
+        for (size_t row = 0; row < neurons.size(); row++) {
+            refreshForwardWeights(row, false);
+        }
+    } else {
+        forwardWeights.clear();
+        forwardWeights.shrink_to_fit();
+    }
+}
+
+WeightPrecision Layer::getWeightPrecision() const {
+    return weightPrecision;
+}
+
+const std::vector<uint16_t>& Layer::getForwardWeights() const {
+    return forwardWeights;
+}
+
+void Layer::refreshForwardWeights(size_t row, bool onlyActiveInputs) {
+    const double* weights = neurons[row].getWeights().data();
+    uint16_t* converted = forwardWeights.data() + row * inputCount;
+    
+    if (onlyActiveInputs) {
+        for (size_t index : activeInputs) {
+            converted[index] = BFloat16::fromFloat(static_cast<float>(weights[index]));
+        }
+    } else {
+        BFloat16::fromDoubles(weights, converted, inputCount);
+    }
+}
+
+void Layer::setPartitionCount(size_t count) {
+    partitionCount = std::max<size_t>(count, 1);
+}
+
+size_t Layer::getPartitionCount() const {
+    return partitionCount;
+}
+
+void Layer::setPruningMask(const std::vector<uint8_t>& mask) {
+    if (!mask.empty() && mask.size() != neurons.size() * inputCount) {
+        throw std::runtime_error("Pruning mask size doesn't match the layer's weight count");
+    }
+    
+    pruningMask = mask;
+    for (size_t row = 0; row < neurons.size() && !pruningMask.empty(); row++) {
+        applyPruningMask(row, false);
+    }
+    if (weightPrecision == WeightPrecision::BF16) {
+        setWeightPrecision(WeightPrecision::BF16);
+    }
+}
+
+const std::vector<uint8_t>& Layer::getPruningMask() const {
+    return pruningMask;
+}
+
+void Layer::applyPruningMask(size_t row, bool onlyActiveInputs) {
+    std::vector<double>& weights = neurons[row].getWeights();
+    const uint8_t* keep = pruningMask.data() + row * inputCount;
+    
+    // Sparse updates only wrote the active columns; the others are still zero where pruned
+    if (onlyActiveInputs) {
+        for (size_t index : activeInputs) {
+            weights[index] = keep[index] ? weights[index] : 0.0;
+        }
+    } else {
+        for (size_t i = 0; i < inputCount; i++) {
+            weights[i] = keep[i] ? weights[i] : 0.0;
+        }
+    }
+}
@@ -0,0 +1,300 @@
+#include "../include/LowRankNetwork.h"
+#include "../include/Activation.h"
+#include "../include/Softmax.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr int MAX_JACOBI_SWEEPS = 60;
+    constexpr double JACOBI_TOLERANCE = 1e-24;  // Off-diagonal over total squared norm
+
+    // Eigen-decomposition of the symmetric n x n matrix a (row-major, destroyed)
+    // by cyclic Jacobi rotations. Eigenvalues end up on the diagonal of a and
+    // eigenvectors in the columns of vectors.
+    void jacobiEigen(std::vector<double>& a, size_t n, std::vector<double>& vectors) {
+        vectors.assign(n * n, 0.0);
+        for (size_t i = 0; i < n; i++) {
+            vectors[i * n + i] = 1.0;
+        }
+
+        double total = 0.0;
+        for (double value : a) {
+            total += value * value;
+        }
+
+        for (int sweep = 0; sweep < MAX_JACOBI_SWEEPS; sweep++) {
+            double offDiagonal = 0.0;
+            for (size_t p = 0; p < n; p++) {
+                for (size_t q = p + 1; q < n; q++) {
+                    offDiagonal += 2.0 * a[p * n + q] * a[p * n + q];
+                }
+            }
+            if (offDiagonal <= JACOBI_TOLERANCE * total) {
+                return;
+            }
+
+            for (size_t p = 0; p < n; p++) {
+                for (size_t q = p + 1; q < n; q++) {
+                    double apq = a[p * n + q];
+                    if (apq == 0.0) {
+                        continue;
+                    }
+
+                    // Rotation angle that zeroes a[p][q]
+                    double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                    double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                    double c = 1.0 / std::sqrt(t * t + 1.0);
+                    double s = t * c;
+
+                    // a = J^T a J, applied to columns p and q, then rows p and q
+                    for (size_t k = 0; k < n; k++) {
+                        double akp = a[k * n + p];
+                        double akq = a[k * n + q];
+                        a[k * n + p] = c * akp - s * akq;
+                        a[k * n + q] = s * akp + c * akq;
+                    }
+                    for (size_t k = 0; k < n; k++) {
+                        double apk = a[p * n + k];
+                        double aqk = a[q * n + k];
+                        a[p * n + k] = c * apk - s * aqk;
+                        a[q * n + k] = s * apk + c * aqk;
+                    }
+                    for (size_t k = 0; k < n; k++) {
+                        double vkp = vectors[k * n + p];
+                        double vkq = vectors[k * n + q];
+                        vectors[k * n + p] = c * vkp - s * vkq;
+                        vectors[k * n + q] = s * vkp + c * vkq;
+                    }
+                }
+            }
+        }
+    }
+
+    // outputs[o] = biases[o] + row o . inputs, for a row-major matrix
+    void multiply(const double* weights, const double* biases, const double* inputs,
+                  size_t outputCount, size_t inputCount, double* outputs) {
+        for (size_t o = 0; o < outputCount; o++) {
+            const double* row = weights + o * inputCount;
+            double sum0 = 0.0;
+            double sum1 = 0.0;
+            size_t i = 0;
+            for (; i + 2 <= inputCount; i += 2) {
+                sum0 += row[i] * inputs[i];
+                sum1 += row[i + 1] * inputs[i + 1];
+            }
+            if (i < inputCount) {
+                sum0 += row[i] * inputs[i];
+            }
+            outputs[o] = (biases ? biases[o] : 0.0) + (sum0 + sum1);
+        }
+    }
+
+    // Activation of weighted sums into outputs (softmax normalized over the layer)
+    void activate(ActivationType type, const double* sums, double* outputs, size_t count) {
+        if (type == ActivationType::SOFTMAX) {
+            std::copy(sums, sums + count, outputs);
+            Softmax::forward(outputs, count);
+        } else {
+            Activation::apply(type, sums, outputs, count);
+        }
+    }
+
+    // Per-call buffers
+    struct Scratch {
+        std::vector<double> projected;
+        std::vector<double> sums;
+        std::vector<double> current;
+    };
+}
+
+LowRankNetwork::LowRankNetwork(const std::vector<Layer>& sourceLayers, size_t initialRank) {
+    if (sourceLayers.empty()) {
+        throw std::runtime_error("Cannot factorize a network with no layers");
+    }
+
+    const Layer& first = sourceLayers.front();
+    const std::vector<Neuron>& neurons = first.getNeurons();
+    inputCount = neurons.front().getWeights().size();
+    firstOutputCount = neurons.size();
+    firstActivationType = first.getActivationType();
+    for (const auto& neuron : neurons) {
+        firstBiases.push_back(neuron.getBias());
+    }
+
+    // Gram matrix W W^T (H x H): its eigenvectors are W's left singular vectors
+    const size_t h = firstOutputCount;
+    std::vector<double> gram(h * h);
+    for (size_t i = 0; i < h; i++) {
+        const std::vector<double>& wi = neurons[i].getWeights();
+        for (size_t j = i; j < h; j++) {
+            const std::vector<double>& wj = neurons[j].getWeights();
+            double dot = std::inner_product(wi.begin(), wi.end(), wj.begin(), 0.0);
+            gram[i * h + j] = dot;
+            gram[j * h + i] = dot;
+        }
+    }
+    std::vector<double> eigenvectors;
+    jacobiEigen(gram, h, eigenvectors);
+
+    std::vector<size_t> order(h);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return gram[a * h + a] > gram[b * h + b];
+    });
+
+    // Keep at most min(H, inputs) terms: beyond that the singular values are zero
+    const size_t maxRank = std::min(h, inputCount);
+    projections.assign(maxRank * inputCount, 0.0);
+    leftVectors.assign(h * maxRank, 0.0);
+    for (size_t r = 0; r < maxRank; r++) {
+        size_t column = order[r];
+        singularValues.push_back(std::sqrt(std::max(gram[column * h + column], 0.0)));
+
+        // projections row r = u^T W; W ~ sum_r u_r (u_r^T W)
+        double* projection = projections.data() + r * inputCount;
+        for (size_t j = 0; j < h; j++) {
+            double u = eigenvectors[j * h + column];
+            leftVectors[j * maxRank + r] = u;
+            const std::vector<double>& row = neurons[j].getWeights();
+            for (size_t i = 0; i < inputCount; i++) {
+                projection[i] += u * row[i];
+            }
+        }
+    }
+
+    for (size_t l = 1; l < sourceLayers.size(); l++) {
+        DenseLayer layer;
+        const std::vector<Neuron>& layerNeurons = sourceLayers[l].getNeurons();
+        layer.inputCount = layerNeurons.front().getWeights().size();
+        layer.outputCount = layerNeurons.size();
+        layer.activationType = sourceLayers[l].getActivationType();
+        for (const auto& neuron : layerNeurons) {
+            const std::vector<double>& row = neuron.getWeights();
+            layer.weights.insert(layer.weights.end(), row.begin(), row.end());
+            layer.biases.push_back(neuron.getBias());
+        }
+        layers.push_back(std::move(layer));
+    }
+
+    setRank(initialRank);
+}
+
+void LowRankNetwork::setRank(size_t newRank) {
+    const size_t maxRank = getMaxRank();
+    if (newRank == 0 || newRank > maxRank) {
+        throw std::runtime_error("Rank must be between 1 and " + std::to_string(maxRank));
+    }
+
+    rank = newRank;
+    expansion.resize(firstOutputCount * rank);
+    for (size_t j = 0; j < firstOutputCount; j++) {
+        std::copy(leftVectors.begin() + j * maxRank, leftVectors.begin() + j * maxRank + rank,
+                  expansion.begin() + j * rank);
+    }
+}
+
+size_t LowRankNetwork::getRank() const {
+    return rank;
+}
+
+size_t LowRankNetwork::getMaxRank() const {
+    return singularValues.size();
+}
+
+const std::vector<double>& LowRankNetwork::getSingularValues() const {
+    return singularValues;
+}
+
+size_t LowRankNetwork::getInputSize() const {
+    return inputCount;
+}
+
+size_t LowRankNetwork::getOutputSize() const {
+    return layers.empty() ? firstOutputCount : layers.back().outputCount;
+}
+
+void LowRankNetwork::infer(const double* input, double* outputs) const {
+    Scratch& scratch = threadLocalScratch<Scratch>();
+
+    // First layer: project onto r directions, then expand to the neurons
+    scratch.projected.resize(rank);
+    multiply(projections.data(), nullptr, input, rank, inputCount, scratch.projected.data());
+    scratch.sums.resize(firstOutputCount);
+    multiply(expansion.data(), firstBiases.data(), scratch.projected.data(), firstOutputCount, rank,
+             scratch.sums.data());
+
+    if (layers.empty()) {
+        activate(firstActivationType, scratch.sums.data(), outputs, firstOutputCount);
+        return;
+    }
+    scratch.current.resize(firstOutputCount);
+    activate(firstActivationType, scratch.sums.data(), scratch.current.data(), firstOutputCount);
+
+    for (size_t l = 0; l < layers.size(); l++) {
+        const DenseLayer& layer = layers[l];
+        bool isOutput = (l + 1 == layers.size());
+
+        scratch.sums.resize(layer.outputCount);
+        multiply(layer.weights.data(), layer.biases.data(), scratch.current.data(), layer.outputCount,
+                 layer.inputCount, scratch.sums.data());
+
+        if (isOutput) {
+            activate(layer.activationType, scratch.sums.data(), outputs, layer.outputCount);
+        } else {
+            scratch.current.resize(layer.outputCount);
+            activate(layer.activationType, scratch.sums.data(), scratch.current.data(), layer.outputCount);
+        }
+    }
+}
+
+double LowRankNetwork::accuracy(const std::vector<std::vector<double>>& inputs,
+                                const std::vector<std::vector<double>>& targets) const {
+    size_t correct = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        int label = static_cast<int>(std::max_element(targets[i].begin(), targets[i].end()) - targets[i].begin());
+        correct += (classify(inputs[i]) == label);
+    }
+    return inputs.empty() ? 0.0 : static_cast<double>(correct) / inputs.size();
+}
+
+size_t LowRankNetwork::chooseRank(const std::vector<std::vector<double>>& inputs,
+                                  const std::vector<std::vector<double>>& targets,
+                                  double maxAccuracyDrop) {
+    if (inputs.size() != targets.size()) {
+        throw std::runtime_error("Number of inputs doesn't match number of targets");
+    }
+
+    setRank(getMaxRank());
+    const double required = accuracy(inputs, targets) - maxAccuracyDrop;
+
+    // Smallest rank in [low, high] meeting the budget; high always does
+    size_t low = 1;
+    size_t high = getMaxRank();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        setRank(middle);
+        if (accuracy(inputs, targets) >= required) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    setRank(high);
+    return high;
+}
+
+size_t LowRankNetwork::getFirstLayerFlops() const {
+    return rank * (inputCount + firstOutputCount);
+}
+
+size_t LowRankNetwork::getModelBytes() const {
+    size_t bytes = (getFirstLayerFlops() + firstBiases.size()) * sizeof(double);
+    for (const auto& layer : layers) {
+        bytes += (layer.weights.size() + layer.biases.size()) * sizeof(double);
+    }
+    return bytes;
+}
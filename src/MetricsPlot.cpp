@@ -0,0 +1,128 @@
+#include "../include/MetricsPlot.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+MetricsPlot::MetricsPlot(const sf::Vector2f& pos, const sf::Vector2f& plotSize, const sf::Font& fontRef)
+    : position(pos), size(plotSize), lossLine(sf::LineStrip), accuracyLine(sf::LineStrip),
+      maxLoss(1.0), pointCount(0),
+      maxVertices(std::max<size_t>(2, static_cast<size_t>(plotSize.x) / 2 * 2)),
+      pointsPerVertex(1), pointsInLastVertex(0), lastLossSum(0.0), lastAccuracySum(0.0) {
+    // Set colors
+    lossColor = sf::Color(70, 130, 180);        // Steel blue
+    accuracyColor = sf::Color(255, 140, 0);     // Dark orange
+
+    // Copy font reference
+    font = fontRef;
+}
+
+void MetricsPlot::consume(TrainingMetricsBuffer& buffer) {
+    BatchMetrics metrics;
+    while (buffer.tryPop(metrics)) {
+        // Start a new vertex once the last one covers its full batch range
+        if (lossLine.getVertexCount() == 0 || pointsInLastVertex == pointsPerVertex) {
+            if (lossLine.getVertexCount() == maxVertices) {
+                mergeVertices();
+            }
+            float x = static_cast<float>(pointCount);
+            lossLine.append(sf::Vertex(sf::Vector2f(x, 0.0f), lossColor));
+            accuracyLine.append(sf::Vertex(sf::Vector2f(x, 0.0f), accuracyColor));
+            pointsInLastVertex = 0;
+            lastLossSum = 0.0;
+            lastAccuracySum = 0.0;
+        }
+
+        // The last vertex shows the mean of the batches it covers so far
+        pointsInLastVertex++;
+        lastLossSum += metrics.loss;
+        lastAccuracySum += metrics.accuracy;
+        size_t last = lossLine.getVertexCount() - 1;
+        lossLine[last].position.y = static_cast<float>(lastLossSum / pointsInLastVertex);
+        accuracyLine[last].position.y = static_cast<float>(lastAccuracySum / pointsInLastVertex);
+
+        maxLoss = std::max(maxLoss, metrics.loss);
+        latest = metrics;
+        pointCount++;
+    }
+}
+
+void MetricsPlot::clear() {
+    lossLine.clear();
+    accuracyLine.clear();
+    maxLoss = 1.0;
+    latest = BatchMetrics();
+    pointCount = 0;
+    pointsPerVertex = 1;
+    pointsInLastVertex = 0;
+    lastLossSum = 0.0;
+    lastAccuracySum = 0.0;
+}
+
+void MetricsPlot::mergeVertices() {
+    // Only called when every vertex covers a full range, so pairs average evenly
+    size_t merged = lossLine.getVertexCount() / 2;
+    for (size_t i = 0; i < merged; i++) {
+        lossLine[i].position = sf::Vector2f(lossLine[2 * i].position.x,
+                                            (lossLine[2 * i].position.y + lossLine[2 * i + 1].position.y) / 2.0f);
+        accuracyLine[i].position = sf::Vector2f(accuracyLine[2 * i].position.x,
+                                                (accuracyLine[2 * i].position.y + accuracyLine[2 * i + 1].position.y) / 2.0f);
+    }
+    lossLine.resize(merged);
+    accuracyLine.resize(merged);
+    pointsPerVertex *= 2;
+}
+
+sf::Transform MetricsPlot::makeTransform(float xRange, float yRange) const {
+    // Plot area leaves a strip at the top for the legend
+    const float legendHeight = 20.0f;
+    float plotHeight = size.y - legendHeight;
+
+    // Map (x, y) to (left + x * sx, bottom - y * sy)
+    sf::Transform transform;
+    transform.translate(position.x, position.y + size.y);
+    transform.scale(size.x / std::max(xRange, 1.0f), -plotHeight / std::max(yRange, 1e-6f));
+    return transform;
+}
+
+void MetricsPlot::draw(sf::RenderWindow& window) const {
+    sf::RectangleShape background(size);
+    background.setPosition(position);
+    background.setFillColor(sf::Color::White);
+    background.setOutlineColor(sf::Color(200, 210, 220));
+    background.setOutlineThickness(2.0f);
+    profiledDraw(window, background);
+
+    // Legend with the latest values
+    std::stringstream ss;
+    if (pointCount == 0) {
+        ss << "Training metrics (train to see live loss/accuracy)";
+    } else {
+        ss << std::fixed << std::setprecision(3) << "Loss " << latest.loss
+           << "  Acc " << std::setprecision(2) << latest.accuracy * 100.0 << "%"
+           << "  " << std::setprecision(0) << latest.samplesPerSecond << " samples/s"
+           << "  (epoch " << latest.epoch + 1 << ")";
+    }
+
+    sf::Text legend;
+    legend.setFont(font);
+    legend.setString(ss.str());
+    legend.setCharacterSize(12);
+    legend.setFillColor(sf::Color(50, 50, 50));
+    legend.setPosition(position.x + 4.0f, position.y + 2.0f);
+    profiledDraw(window, legend);
+
+    if (lossLine.getVertexCount() < 2) {
+        return;
+    }
+
+    // Both series share the x axis (vertices sit at the first batch they cover);
+    // loss is scaled to its maximum, accuracy to [0, 1]
+    float xRange = lossLine[lossLine.getVertexCount() - 1].position.x;
+    profiledDraw(window, lossLine, sf::RenderStates(makeTransform(xRange, static_cast<float>(maxLoss))));
+    profiledDraw(window, accuracyLine, sf::RenderStates(makeTransform(xRange, 1.0f)));
+}
+
+size_t MetricsPlot::getPointCount() const {
+    return pointCount;
+}
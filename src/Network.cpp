@@ -1,6 +1,13 @@
 #include "../include/Network.h"
+#include "../include/Trace.h"
+#include "../include/ThreadPool.h"
+#include <tuple>
 
-Network::Network(double lr) : learningRate(lr), rng(rd()) {
+namespace {
+    constexpr size_t LOAD_GRAIN_LINES = 64;    // CSV lines parsed per loader task
+}
+
+Network::Network(double lr) : learningRate(lr), weightPrecision(WeightPrecision::DOUBLE), partitionMinWidth(0), partitionsPerLayer(0), rng(rd()), metricsBuffer(nullptr), snapshotPublisher(nullptr), stopRequested(false) {
     // Initialize random number generator
 }
 
@@ -19,6 +26,35 @@ void Network::addLayer(size_t neuronCount, ActivationType type) {
     
     // Create and add the new layer
     layers.emplace_back(neuronCount, inputsPerNeuron, type);
+    layers.back().setWeightPrecision(weightPrecision);
+    applyPartitioning(layers.back());
+}
+
+void Network::setWeightPrecision(WeightPrecision precision) {
+    weightPrecision = precision;
+    for (auto& layer : layers) {
+        layer.setWeightPrecision(precision);
+    }
+}
+
+WeightPrecision Network::getWeightPrecision() const {
+    return weightPrecision;
+}
+
+void Network::setModelParallelism(size_t minLayerWidth, size_t partitions) {
+    partitionMinWidth = minLayerWidth;
+    partitionsPerLayer = partitions;
+    for (auto& layer : layers) {
+        applyPartitioning(layer);
+    }
+}
+
+void Network::applyPartitioning(Layer& layer) const {
+    if (partitionMinWidth == 0 || layer.getNeuronCount() < partitionMinWidth) {
+        layer.setPartitionCount(1);
+        return;
+    }
+    layer.setPartitionCount(partitionsPerLayer > 0 ? partitionsPerLayer : ThreadPool::global().getConcurrency());
 }
 
 std::vector<double> Network::forwardPropagate(const std::vector<double>& inputs) {
@@ -38,33 +74,54 @@ std::vector<double> Network::forwardPropagate(const std::vector<double>& inputs)
     return currentInputs;
 }
 
-double Network::trainSingle(const std::vector<double>& inputs, const std::vector<double>& targets) {
-    // Forward pass
-    std::vector<double> outputs = forwardPropagate(inputs);
+double Network::forwardPropagateWithLoss(const std::vector<double>& inputs, const std::vector<double>& targets) {
+    if (layers.empty()) {
+        throw std::runtime_error("Network has no layers");
+    }
     
-    // Calculate loss
-    double loss = calculateLoss(outputs, targets);
+    Layer& outputLayer = layers.back();
+    if (outputLayer.getActivationType() != ActivationType::SOFTMAX) {
+        // No fused kernel: separate forward, loss and output delta passes
+        double loss = calculateLoss(forwardPropagate(inputs), targets);
+        outputLayer.calculateOutputLayerDeltas(targets);
+        return loss;
+    }
     
-    // Backward pass (backpropagation)
+    // Hidden layers, then softmax, loss and output deltas fused in the output layer
+    std::vector<double> currentInputs = inputs;
+    for (size_t i = 0; i + 1 < layers.size(); i++) {
+        layers[i].forwardPropagate(currentInputs);
+        currentInputs = layers[i].getOutputs();
+    }
     
-    // 1. Calculate deltas for output layer
-    layers.back().calculateOutputLayerDeltas(targets);
+    return outputLayer.forwardPropagateWithLoss(currentInputs, targets);
+}
+
+double Network::trainSingle(const std::vector<double>& inputs, const std::vector<double>& targets) {
+    double loss = 0.0;
     
-    // 2. Calculate deltas for hidden layers, working backwards
-    for (int i = static_cast<int>(layers.size()) - 2; i >= 0; i--) {
-        layers[i].calculateHiddenLayerDeltas(layers[i + 1]);
+    // Forward pass, loss and output layer deltas
+    {
+        NN_TRACE_SCOPE("Forward");
+        loss = forwardPropagateWithLoss(inputs, targets);
     }
     
-    // 3. Update weights for all layers
-    for (auto& layer : layers) {
-        layer.updateWeights(learningRate);
+    // Backward pass fused with the weight updates: each layer propagates its deltas
+    // to the layer below using its pre-update weights, then updates them in the same sweep
+    {
+        NN_TRACE_SCOPE("Backward+update");
+        for (size_t i = layers.size() - 1; i > 0; i--) {
+            layers[i].propagateDeltasAndUpdateWeights(layers[i - 1], learningRate);
+        }
+        layers.front().updateWeights(learningRate);
     }
     
     return loss;
 }
 
 double Network::trainBatch(const std::vector<std::vector<double>>& batchInputs, 
-                         const std::vector<std::vector<double>>& batchTargets) {
+                         const std::vector<std::vector<double>>& batchTargets,
+                         int* correctCount) {
     if (batchInputs.size() != batchTargets.size()) {
         throw std::runtime_error("Number of inputs doesn't match number of targets in batch");
     }
@@ -74,20 +131,39 @@ double Network::trainBatch(const std::vector<std::vector<double>>& batchInputs,
     // Train on each sample in the batch
     for (size_t i = 0; i < batchInputs.size(); i++) {
         totalLoss += trainSingle(batchInputs[i], batchTargets[i]);
+        
+        // Output neurons still hold this sample's forward pass outputs
+        if (correctCount && getMaxOutputIndex(layers.back().getOutputs()) == getMaxOutputIndex(batchTargets[i])) {
+            (*correctCount)++;
+        }
     }
     
     // Return average loss
     return totalLoss / batchInputs.size();
 }
 
-void Network::train(const std::string& trainFile, int epochs, int batchSize) {
+TrainingTelemetry Network::train(const std::string& trainFile, int epochs, int batchSize) {
+    TrainingTelemetry telemetry;
+    
     try {
         // Load training data
-        auto [inputs, targets] = loadMNISTData(trainFile);
+        std::vector<std::vector<double>> inputs;
+        std::vector<std::vector<double>> targets;
+        {
+            NN_TRACE_SCOPE("Load training data");
+            auto loadStart = std::chrono::steady_clock::now();
+            size_t allocationsBefore = Telemetry::getAllocationCount();
+            
+            std::tie(inputs, targets) = loadMNISTData(trainFile);
+            
+            telemetry.loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+            telemetry.loadAllocations = Telemetry::getAllocationCount() - allocationsBefore;
+        }
         
         if (inputs.empty() || targets.empty()) {
             std::cerr << "Error: No training data loaded from " << trainFile << std::endl;
-            return;
+            stopRequested.store(false);
+            return telemetry;
         }
         
         std::cout << "Training on " << inputs.size() << " samples for " << epochs << " epochs..." << std::endl;
@@ -96,8 +172,28 @@ void Network::train(const std::string& trainFile, int epochs, int batchSize) {
         std::vector<size_t> indices(inputs.size());
         std::iota(indices.begin(), indices.end(), 0);
         
+        size_t batchIndex = 0;
+        
+        // Give readers a consistent model before the first update
+        if (snapshotPublisher) {
+            snapshotPublisher->resetStats();
+            snapshotPublisher->publish(layers);
+        }
+        
         // Train for multiple epochs
-        for (int epoch = 0; epoch < epochs; epoch++) {
+        for (int epoch = 0; epoch < epochs && !stopRequested.load(); epoch++) {
+            NN_TRACE_SCOPE_ARG("Epoch", "epoch", epoch);
+            
+            EpochTelemetry epochTelemetry;
+            epochTelemetry.epoch = epoch;
+            std::vector<double> batchLatencies;
+            auto epochStart = std::chrono::steady_clock::now();
+            size_t allocationsBefore = Telemetry::getThreadAllocationCount();
+            size_t bytesBefore = Telemetry::getThreadAllocatedBytes();
+            for (auto& layer : layers) {
+                layer.resetSparsityStats();
+            }
+            
             // Shuffle the data
             std::shuffle(indices.begin(), indices.end(), rng);
             
@@ -105,76 +201,150 @@ void Network::train(const std::string& trainFile, int epochs, int batchSize) {
             int numBatches = 0;
             
             // Process in batches
-            for (size_t i = 0; i < inputs.size(); i += batchSize) {
+            for (size_t i = 0; i < inputs.size() && !stopRequested.load(); i += batchSize) {
+                auto batchStart = std::chrono::steady_clock::now();
+                
                 std::vector<std::vector<double>> batchInputs;
                 std::vector<std::vector<double>> batchTargets;
                 
                 // Create batch
-                size_t endIdx = std::min(i + batchSize, inputs.size());
-                for (size_t j = i; j < endIdx; j++) {
-                    size_t idx = indices[j];
-                    batchInputs.push_back(inputs[idx]);
-                    batchTargets.push_back(targets[idx]);
+                {
+                    NN_TRACE_SCOPE("Batch assembly");
+                    size_t endIdx = std::min(i + batchSize, inputs.size());
+                    for (size_t j = i; j < endIdx; j++) {
+                        size_t idx = indices[j];
+                        batchInputs.push_back(inputs[idx]);
+                        batchTargets.push_back(targets[idx]);
+                    }
                 }
+                auto computeStart = std::chrono::steady_clock::now();
                 
                 // Train on batch
-                double batchLoss = trainBatch(batchInputs, batchTargets);
+                int correct = 0;
+                double batchLoss = 0.0;
+                {
+                    NN_TRACE_SCOPE_ARG("Train batch", "samples", batchInputs.size());
+                    batchLoss = trainBatch(batchInputs, batchTargets, metricsBuffer ? &correct : nullptr);
+                }
                 epochLoss += batchLoss;
                 numBatches++;
+                
+                auto batchEnd = std::chrono::steady_clock::now();
+                std::chrono::duration<double> assemblyTime = computeStart - batchStart;
+                std::chrono::duration<double> computeTime = batchEnd - computeStart;
+                epochTelemetry.batchAssemblySeconds += assemblyTime.count();
+                epochTelemetry.computeSeconds += computeTime.count();
+                epochTelemetry.samples += batchInputs.size();
+                batchLatencies.push_back(computeTime.count() * 1000.0);
+                
+                // Publish batch metrics (dropped if the consumer has fallen behind)
+                if (metricsBuffer) {
+                    std::chrono::duration<double> elapsed = batchEnd - batchStart;
+                    BatchMetrics metrics;
+                    metrics.epoch = epoch;
+                    metrics.batch = batchIndex;
+                    metrics.loss = batchLoss;
+                    metrics.accuracy = static_cast<double>(correct) / batchInputs.size();
+                    metrics.samplesPerSecond = elapsed.count() > 0.0 ? batchInputs.size() / elapsed.count() : 0.0;
+                    metricsBuffer->tryPush(metrics);
+                }
+                batchIndex++;
+                
+                // Let readers see the new weights (rate- and cost-limited by the publisher)
+                if (snapshotPublisher) {
+                    snapshotPublisher->publishIfDue(layers);
+                }
+            }
+            
+            if (numBatches == 0) {
+                break;
             }
             
             // Calculate average loss for the epoch
             epochLoss /= numBatches;
             
+            // Finish the epoch's telemetry
+            epochTelemetry.batches = numBatches;
+            epochTelemetry.loss = epochLoss;
+            epochTelemetry.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - epochStart).count();
+            epochTelemetry.samplesPerSecond = epochTelemetry.wallSeconds > 0.0 ? epochTelemetry.samples / epochTelemetry.wallSeconds : 0.0;
+            epochTelemetry.batchLatencyP50Ms = Telemetry::percentile(batchLatencies, 50.0);
+            epochTelemetry.batchLatencyP99Ms = Telemetry::percentile(batchLatencies, 99.0);
+            epochTelemetry.batchLatencyMaxMs = *std::max_element(batchLatencies.begin(), batchLatencies.end());
+            epochTelemetry.peakResidentBytes = Telemetry::getPeakResidentBytes();
+            epochTelemetry.allocations = Telemetry::getThreadAllocationCount() - allocationsBefore;
+            epochTelemetry.allocatedBytes = Telemetry::getThreadAllocatedBytes() - bytesBefore;
+            
+            size_t skippedRows = 0;
+            size_t backpropRows = 0;
+            for (const auto& layer : layers) {
+                skippedRows += layer.getSkippedRowCount();
+                backpropRows += layer.getBackpropRowCount();
+            }
+            epochTelemetry.skippedRowFraction = backpropRows > 0 ? static_cast<double>(skippedRows) / backpropRows : 0.0;
+            telemetry.epochs.push_back(epochTelemetry);
+            
             std::cout << "Epoch " << (epoch + 1) << "/" << epochs 
-                      << ", Loss: " << epochLoss << std::endl;
+                      << ", Loss: " << epochLoss
+                      << ", " << static_cast<long>(epochTelemetry.samplesPerSecond) << " samples/s"
+                      << ", batch p50/p99: " << epochTelemetry.batchLatencyP50Ms << "/" << epochTelemetry.batchLatencyP99Ms << " ms"
+                      << ", " << epochTelemetry.skippedRowFraction * 100.0 << "% rows skipped"
+                      << ", batch assembly " << epochTelemetry.batchAssemblySeconds << " s, compute " << epochTelemetry.computeSeconds << " s"
+                      << ", peak RSS " << epochTelemetry.peakResidentBytes / (1024 * 1024) << " MB"
+                      << ", " << epochTelemetry.allocations << " allocations" << std::endl;
+        }
+        
+        // Final weights, and the cost publishing added to the training loop
+        if (snapshotPublisher) {
+            snapshotPublisher->publish(layers);
+            SnapshotPublishStats stats = snapshotPublisher->getStats();
+            std::cout << "Published " << stats.publishCount << " weight snapshots, "
+                      << stats.totalPublishSeconds * 1000.0 << " ms total (max "
+                      << stats.maxPublishSeconds * 1000.0 << " ms, "
+                      << stats.overheadFraction * 100.0 << "% of training time)" << std::endl;
+        }
+        
+        // Optional JSON lines log for tracking regressions across runs
+        if (!telemetryLogPath.empty() && !telemetry.appendJsonLines(telemetryLogPath)) {
+            std::cerr << "Could not write telemetry to " << telemetryLogPath << std::endl;
         }
     } catch (const std::exception& e) {
         std::cerr << "Exception during training: " << e.what() << std::endl;
     }
+    
+    // A stop request only applies to the call it interrupted
+    stopRequested.store(false);
+    
+    return telemetry;
+}
+
+void Network::setTelemetryLog(const std::string& path) {
+    telemetryLogPath = path;
+}
+
+void Network::setMetricsBuffer(TrainingMetricsBuffer* buffer) {
+    metricsBuffer = buffer;
+}
+
+void Network::setSnapshotPublisher(SnapshotPublisher* publisher) {
+    snapshotPublisher = publisher;
+}
+
+void Network::requestStop() {
+    stopRequested.store(true);
 }
 
 double Network::test(const std::string& testFile, int numSamples) {
-    // Mark parameter as unused to silence compiler warning
-    (void)numSamples;
-    
     try {
-        // Load test data
-        auto [inputs, targets] = loadMNISTData(testFile);
-        
-        if (inputs.empty() || targets.empty()) {
+        EvaluationReport report = evaluate(testFile, numSamples);
+        if (report.samples == 0) {
             std::cerr << "Error: No test data loaded from " << testFile << std::endl;
             return 0.0;
         }
         
-        int correct = 0;
-        double totalLoss = 0.0;
-        
-        // Test each sample
-        for (size_t i = 0; i < inputs.size(); i++) {
-            // Forward pass
-            std::vector<double> outputs = forwardPropagate(inputs[i]);
-            
-            // Get predicted digit
-            int predicted = getMaxOutputIndex(outputs);
-            
-            // Get target digit
-            int target = getMaxOutputIndex(targets[i]);
-            
-            // Check if prediction is correct
-            if (predicted == target) {
-                correct++;
-            }
-            
-            // Calculate loss
-            totalLoss += calculateLoss(outputs, targets[i]);
-        }
-        
-        // Calculate accuracy and average loss
-        double accuracy = static_cast<double>(correct) / inputs.size();
-        double avgLoss = totalLoss / inputs.size();
-        
-        std::cout << "Test Accuracy: " << (accuracy * 100.0) << "%, Loss: " << avgLoss << std::endl;
+        double accuracy = report.getAccuracy();
+        std::cout << "Test Accuracy: " << (accuracy * 100.0) << "%, Loss: " << report.loss
+                  << " (" << report.samples << " samples)" << std::endl;
         
         return accuracy;
     } catch (const std::exception& e) {
@@ -183,6 +353,19 @@ double Network::test(const std::string& testFile, int numSamples) {
     }
 }
 
+EvaluationReport Network::evaluate(const std::string& testFile, int numSamples) {
+    // Load only the samples that will be evaluated
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> targets;
+    {
+        NN_TRACE_SCOPE("Load test data");
+        std::tie(inputs, targets) = loadMNISTData(testFile, numSamples);
+    }
+    
+    NN_TRACE_SCOPE_ARG("Evaluate", "samples", inputs.size());
+    return Evaluator(*this).evaluate(inputs, targets);
+}
+
 int Network::predict(const std::vector<double>& input) {
     // Forward pass
     std::vector<double> output = forwardPropagate(input);
@@ -198,35 +381,37 @@ Network::loadMNISTData(const std::string& filename, int numSamples) {
         throw std::runtime_error("Could not open file: " + filename);
     }
     
-    std::vector<std::vector<double>> inputs;
-    std::vector<std::vector<double>> targets;
-    
+    // Read the lines, then parse them in parallel into their own slots (keeps file order)
+    std::vector<std::string> lines;
     std::string line;
-    int count = 0;
+    while ((numSamples == -1 || static_cast<int>(lines.size()) < numSamples) && std::getline(file, line)) {
+        lines.push_back(std::move(line));
+    }
     
-    while (std::getline(file, line) && (numSamples == -1 || count < numSamples)) {
-        std::stringstream ss(line);
-        std::string value;
-        
-        // Read the label (first value in the row)
-        std::getline(ss, value, ',');
-        int label = std::stoi(value);
-        
-        // Convert label to target vector
-        std::vector<double> target = labelToTarget(label);
-        
-        // Read pixel values (remaining values in the row)
-        std::vector<double> input;
-        while (std::getline(ss, value, ',')) {
-            // Normalize pixel values to [0,1]
-            double pixelValue = std::stod(value) / 255.0;
-            input.push_back(pixelValue);
+    std::vector<std::vector<double>> inputs(lines.size());
+    std::vector<std::vector<double>> targets(lines.size());
+    
+    ThreadPool::global().parallelFor(0, lines.size(), LOAD_GRAIN_LINES, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            std::stringstream ss(lines[i]);
+            std::string value;
+            
+            // Read the label (first value in the row)
+            std::getline(ss, value, ',');
+            int label = std::stoi(value);
+            
+            // Convert label to target vector
+            targets[i] = labelToTarget(label);
+            
+            // Read pixel values (remaining values in the row)
+            std::vector<double>& input = inputs[i];
+            while (std::getline(ss, value, ',')) {
+                // Normalize pixel values to [0,1]
+                double pixelValue = std::stod(value) / 255.0;
+                input.push_back(pixelValue);
+            }
         }
-        
-        inputs.push_back(input);
-        targets.push_back(target);
-        count++;
-    }
+    });
     
     return {inputs, targets};
 }
@@ -269,6 +454,10 @@ const std::vector<Layer>& Network::getLayers() const {
     return layers;
 }
 
+std::vector<Layer>& Network::getLayers() {
+    return layers;
+}
+
 std::vector<std::vector<double>> Network::getAllActivations(const std::vector<double>& input) const {
     std::vector<std::vector<double>> allActivations;
     
@@ -280,14 +469,56 @@ std::vector<std::vector<double>> Network::getAllActivations(const std::vector<do
     std::vector<double> currentInput = input;
     allActivations.push_back(currentInput);
     
-    // Process through each layer
-    for (auto& layer : layers) {
-        // We need a non-const copy of the layer to call forwardPropagate
-        Layer layerCopy = layer;
-        layerCopy.forwardPropagate(currentInput);
-        currentInput = layerCopy.getOutputs();
+    // Process through each layer without touching the layers' stored state
+    for (const auto& layer : layers) {
+        currentInput = layer.computeOutputs(currentInput);
         allActivations.push_back(currentInput);
     }
     
     return allActivations;
-} 
\ No newline at end of file
+}
+
+size_t Network::getInputSize() const {
+    // Every network takes MNIST images (see addLayer)
+    return 784;
+}
+
+size_t Network::getOutputSize() const {
+    return layers.empty() ? 0 : layers.back().getNeuronCount();
+}
+
+void Network::infer(const double* input, double* outputs) const {
+    if (layers.empty()) {
+        throw std::runtime_error("Network has no layers");
+    }
+    
+    // Per-thread buffers: after the first call on a thread, inference doesn't allocate
+    thread_local std::vector<double> currentInput;
+    thread_local std::vector<double> layerOutputs;
+    thread_local Layer::InferenceScratch scratch;
+    
+    currentInput.assign(input, input + getInputSize());
+    for (const auto& layer : layers) {
+        layer.computeOutputs(currentInput, layerOutputs, scratch);
+        currentInput.swap(layerOutputs);
+    }
+    
+    std::copy(currentInput.begin(), currentInput.end(), outputs);
+}
+
+void Network::inferBatch(const double* inputs, size_t count, double* outputs) const {
+    if (layers.empty()) {
+        throw std::runtime_error("Network has no layers");
+    }
+    
+    // Layer by layer over the whole batch, so each weight row is reused across samples
+    std::vector<double> currentInputs(inputs, inputs + count * getInputSize());
+    std::vector<double> nextInputs;
+    for (const auto& layer : layers) {
+        nextInputs.resize(count * layer.getNeuronCount());
+        layer.computeOutputsBatch(currentInputs.data(), count, nextInputs.data());
+        currentInputs.swap(nextInputs);
+    }
+    
+    std::copy(currentInputs.begin(), currentInputs.end(), outputs);
+}
@@ -1,4 +1,5 @@
 #include "../include/NetworkVisualizer.h"
+#include "../include/Profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -117,7 +118,7 @@ void NetworkVisualizer::draw(sf::RenderWindow& window) const {
         placeholder.setOutlineColor(sf::Color(200, 200, 220));
         placeholder.setOutlineThickness(2.0f);
         
-        window.draw(placeholder);
+        profiledDraw(window, placeholder);
         
         // Draw text indicating no network with better formatting
         sf::Text noNetworkText;
@@ -127,7 +128,7 @@ void NetworkVisualizer::draw(sf::RenderWindow& window) const {
         noNetworkText.setFillColor(sf::Color(100, 100, 120));
         noNetworkText.setPosition(position.x + size.x / 2.0f - 120, position.y + size.y / 2.0f - 40);
         
-        window.draw(noNetworkText);
+        profiledDraw(window, noNetworkText);
         return;
     }
     
@@ -170,7 +171,7 @@ void NetworkVisualizer::draw(sf::RenderWindow& window) const {
                                textBounds.top + textBounds.height / 2.0f);
                 label.setPosition(neuronPositions[i][j]);
                 
-                window.draw(label);
+                profiledDraw(window, label);
             }
         }
     }
@@ -190,7 +191,7 @@ void NetworkVisualizer::draw(sf::RenderWindow& window) const {
             highlight.setOutlineThickness(2.0f);
             highlight.setOutlineColor(sf::Color::Yellow);
             
-            window.draw(highlight);
+            profiledDraw(window, highlight);
         }
     }
 }
@@ -210,7 +211,7 @@ void NetworkVisualizer::drawLayerBackground(sf::RenderWindow& window, size_t lay
         background.setFillColor(hiddenLayerColor);
     }
     
-    window.draw(background);
+    profiledDraw(window, background);
 }
 
 void NetworkVisualizer::drawNeuron(sf::RenderWindow& window, const sf::Vector2f& pos, 
@@ -237,7 +238,7 @@ void NetworkVisualizer::drawNeuron(sf::RenderWindow& window, const sf::Vector2f&
         neuron.setOutlineColor(sf::Color::Red);
     }
     
-    window.draw(neuron);
+    profiledDraw(window, neuron);
     
     // Add activation value for output neurons
     if (isOutput) {
@@ -255,7 +256,7 @@ void NetworkVisualizer::drawNeuron(sf::RenderWindow& window, const sf::Vector2f&
         // Position the text to the right of the neuron
         valueText.setPosition(pos.x + neuronRadius + 5, pos.y - 6);
         
-        window.draw(valueText);
+        profiledDraw(window, valueText);
     }
 }
 
@@ -275,7 +276,7 @@ void NetworkVisualizer::drawConnections(sf::RenderWindow& window, size_t fromLay
                 sf::Vertex(toPos, connectionColor)
             };
             
-            window.draw(line, 2, sf::Lines);
+            profiledDraw(window, line, 2, sf::Lines);
         }
     }
 }
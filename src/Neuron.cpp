@@ -17,6 +17,11 @@ Neuron::Neuron(int inputConnections, ActivationType type) : activationType(type)
 }
 
 void Neuron::computeOutput(const std::vector<double>& inputs) {
+    // Compute weighted sum and apply activation function
+    output = activate(computeWeightedSum(inputs));
+}
+
+double Neuron::computeWeightedSum(const std::vector<double>& inputs) const {
     // Check that input size matches weights size
     if (inputs.size() != weights.size()) {
         throw std::runtime_error("Input size doesn't match weights size in neuron");
@@ -28,40 +33,36 @@ void Neuron::computeOutput(const std::vector<double>& inputs) {
         sum += inputs[i] * weights[i];
     }
     
-    // Apply activation function
-    output = activate(sum);
+    return sum;
 }
 
-double Neuron::activate(double x) const {
-    switch (activationType) {
-        case ActivationType::RELU:
-            // ReLU activation: max(0, x)
-            return std::max(0.0, x);
-            
-        case ActivationType::SOFTMAX:
-            // For Softmax, we just return the input because Softmax
-            // operates on the entire layer, not individual neurons
-            return x;
-            
-        default:
-            throw std::runtime_error("Unknown activation type");
+double Neuron::computeWeightedSum(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs) const {
+    if (inputs.size() != weights.size()) {
+        throw std::runtime_error("Input size doesn't match weights size in neuron");
     }
+    
+    double sum = bias;
+    for (size_t index : activeInputs) {
+        sum += inputs[index] * weights[index];
+    }
+    
+    return sum;
+}
+
+double Neuron::activate(double x) const {
+    // For Softmax this returns x: softmax operates on the entire layer, not individual neurons
+    double y;
+    Activation::apply(activationType, &x, &y, 1);
+    return y;
 }
 
 double Neuron::activateDerivative(double x) const {
-    switch (activationType) {
-        case ActivationType::RELU:
-            // Derivative of ReLU: 0 if x < 0, 1 if x > 0
-            return x > 0 ? 1.0 : 0.0;
-            
-        case ActivationType::SOFTMAX:
-            // For Softmax derivative, we handle it specially in the Network class
-            // because it depends on all outputs in the layer
-            return 1.0; 
-            
-        default:
-            throw std::runtime_error("Unknown activation type");
-    }
+    // For Softmax this is 1: the output layer delta is handled with the loss (see Softmax::forward)
+    double y;
+    double d;
+    Activation::apply(activationType, &x, &y, 1);
+    Activation::derivative(activationType, &x, &y, &d, 1);
+    return d;
 }
 
 double Neuron::getOutput() const {
@@ -94,6 +95,53 @@ void Neuron::updateWeights(const std::vector<double>& inputs, double learningRat
     bias += learningRate * delta;
 }
 
+void Neuron::updateWeights(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs, double learningRate) {
+    // Zero inputs leave their weights unchanged
+    const double step = learningRate * delta;
+    for (size_t index : activeInputs) {
+        weights[index] += step * inputs[index];
+    }
+    
+    bias += step;
+}
+
+void Neuron::propagateAndUpdateWeights(const std::vector<double>& inputs, double learningRate, double* weightedDeltaSums) {
+    propagateAndUpdateWeightRange(inputs, 0, weights.size(), learningRate, weightedDeltaSums);
+    updateBias(learningRate);
+}
+
+void Neuron::propagateAndUpdateWeights(const std::vector<double>& inputs, const std::vector<size_t>& activeInputs,
+                                       double learningRate, double* weightedDeltaSums) {
+    const size_t* active = activeInputs.data();
+    propagateAndUpdateWeightRange(inputs, active, active + activeInputs.size(), learningRate, weightedDeltaSums);
+    updateBias(learningRate);
+}
+
+void Neuron::propagateAndUpdateWeightRange(const std::vector<double>& inputs, size_t begin, size_t end,
+                                           double learningRate, double* weightedDeltaSums) {
+    // One sweep over the weights: read each for the previous layer's deltas, then update it
+    const double step = learningRate * delta;
+    double* w = weights.data();
+    const double* in = inputs.data();
+    for (size_t i = begin; i < end; i++) {
+        weightedDeltaSums[i] += delta * w[i];
+        w[i] += step * in[i];
+    }
+}
+
+void Neuron::propagateAndUpdateWeightRange(const std::vector<double>& inputs, const size_t* firstActive,
+                                           const size_t* lastActive, double learningRate, double* weightedDeltaSums) {
+    const double step = learningRate * delta;
+    for (const size_t* index = firstActive; index != lastActive; index++) {
+        weightedDeltaSums[*index] += delta * weights[*index];
+        weights[*index] += step * inputs[*index];
+    }
+}
+
+void Neuron::updateBias(double learningRate) {
+    bias += learningRate * delta;
+}
+
 void Neuron::calculateOutputDelta(double target) {
     // For output neurons, delta is (target - output) * derivative of activation
     // This is simplified for cross-entropy loss with softmax, where the delta
@@ -101,18 +149,6 @@ void Neuron::calculateOutputDelta(double target) {
     delta = target - output;
 }
 
-void Neuron::calculateHiddenDelta(const std::vector<Neuron>& nextLayer, size_t myIndex) {
-    // For hidden neurons, delta is the sum of (next_layer_deltas * weights) * derivative of activation
-    double sum = 0.0;
-    
-    for (size_t i = 0; i < nextLayer.size(); i++) {
-        sum += nextLayer[i].getDelta() * nextLayer[i].getWeight(myIndex);
-    }
-    
-    // Multiply by derivative of our activation function
-    delta = sum * activateDerivative(output);
-}
-
 double Neuron::getWeight(size_t index) const {
     if (index >= weights.size()) {
         throw std::out_of_range("Weight index out of range");
@@ -122,4 +158,12 @@ double Neuron::getWeight(size_t index) const {
 
 const std::vector<double>& Neuron::getWeights() const {
     return weights;
-} 
\ No newline at end of file
+}
+
+std::vector<double>& Neuron::getWeights() {
+    return weights;
+}
+
+double Neuron::getBias() const {
+    return bias;
+}
@@ -0,0 +1,197 @@
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+size_t Profiler::drawCallCounter = 0;
+
+Profiler::ScopedTimer::ScopedTimer(Profiler& profilerRef, Section timedSection)
+    : profiler(profilerRef), section(timedSection), start(std::chrono::steady_clock::now()) {
+}
+
+Profiler::ScopedTimer::~ScopedTimer() {
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    profiler.addSectionTime(section, elapsed.count());
+}
+
+Profiler::Profiler()
+    : frameIntervals(FRAME_HISTORY, 0.0), frameWorkTimes(FRAME_HISTORY, 0.0),
+      frameDrawCalls(FRAME_HISTORY, 0), frameCount(0), frameStarted(false),
+      overlayVisible(false), framesSinceOverlayRefresh(0) {
+    for (auto& history : sectionHistory) {
+        history.assign(FRAME_HISTORY, 0.0);
+    }
+    currentSectionTimes.fill(0.0);
+    lastSectionTimes.fill(0.0);
+}
+
+void Profiler::beginFrame() {
+    auto now = std::chrono::steady_clock::now();
+
+    // The interval since the previous frame start covers everything, including display()
+    if (frameStarted) {
+        std::chrono::duration<double, std::milli> interval = now - frameStart;
+        frameIntervals[(frameCount - 1) % FRAME_HISTORY] = interval.count();
+    }
+
+    frameStart = now;
+    frameStarted = true;
+    currentSectionTimes.fill(0.0);
+    drawCallCounter = 0;
+}
+
+void Profiler::endFrame() {
+    if (!frameStarted) {
+        return;
+    }
+
+    std::chrono::duration<double, std::milli> work = std::chrono::steady_clock::now() - frameStart;
+    size_t slot = frameCount % FRAME_HISTORY;
+
+    frameWorkTimes[slot] = work.count();
+    frameDrawCalls[slot] = drawCallCounter;
+    for (size_t i = 0; i < SECTION_COUNT; i++) {
+        sectionHistory[i][slot] = currentSectionTimes[i];
+    }
+
+    frameCount++;
+}
+
+void Profiler::addSectionTime(Section section, double milliseconds) {
+    size_t index = static_cast<size_t>(section);
+    currentSectionTimes[index] += milliseconds;
+    lastSectionTimes[index] = milliseconds;
+}
+
+void Profiler::countDrawCall() {
+    drawCallCounter++;
+}
+
+double Profiler::percentile(const std::vector<double>& history, double p) const {
+    // Only the slots filled so far are meaningful
+    size_t count = std::min(frameCount, FRAME_HISTORY);
+    if (count == 0) {
+        return 0.0;
+    }
+
+    std::vector<double> sorted(history.begin(), history.begin() + count);
+    size_t rank = static_cast<size_t>(p / 100.0 * (count - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+double Profiler::getFrameTimePercentile(double p) const {
+    return percentile(frameIntervals, p);
+}
+
+double Profiler::getSectionAverage(Section section) const {
+    size_t count = std::min(frameCount, FRAME_HISTORY);
+    if (count == 0) {
+        return 0.0;
+    }
+
+    const std::vector<double>& history = sectionHistory[static_cast<size_t>(section)];
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        total += history[i];
+    }
+    return total / count;
+}
+
+double Profiler::getLastSectionTime(Section section) const {
+    return lastSectionTimes[static_cast<size_t>(section)];
+}
+
+size_t Profiler::getLastFrameDrawCalls() const {
+    if (frameCount == 0) {
+        return 0;
+    }
+    return frameDrawCalls[(frameCount - 1) % FRAME_HISTORY];
+}
+
+void Profiler::toggleOverlay() {
+    overlayVisible = !overlayVisible;
+    framesSinceOverlayRefresh = 0;
+    overlayLines.clear();
+}
+
+bool Profiler::isOverlayVisible() const {
+    return overlayVisible;
+}
+
+void Profiler::refreshOverlayText() {
+    overlayLines.clear();
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    double p50 = getFrameTimePercentile(50.0);
+    ss << "Frame p50 " << p50 << " / p95 " << getFrameTimePercentile(95.0)
+       << " / p99 " << getFrameTimePercentile(99.0) << " ms";
+    if (p50 > 0.0) {
+        ss << " (" << std::setprecision(0) << 1000.0 / p50 << " FPS)" << std::setprecision(2);
+    }
+    overlayLines.push_back(ss.str());
+
+    ss.str("");
+    ss << "CPU work p50 " << percentile(frameWorkTimes, 50.0) << " / p99 "
+       << percentile(frameWorkTimes, 99.0) << " ms";
+    overlayLines.push_back(ss.str());
+
+    ss.str("");
+    ss << "Draw calls: " << getLastFrameDrawCalls();
+    overlayLines.push_back(ss.str());
+
+    // Per-section averages (inference happens on demand, so show its last latency instead)
+    for (size_t i = 0; i < SECTION_COUNT; i++) {
+        Section section = static_cast<Section>(i);
+        ss.str("");
+        if (section == Section::INFERENCE) {
+            ss << getSectionName(section) << ": last " << getLastSectionTime(section) << " ms";
+        } else {
+            ss << getSectionName(section) << ": " << getSectionAverage(section) << " ms/frame";
+        }
+        overlayLines.push_back(ss.str());
+    }
+}
+
+void Profiler::drawOverlay(sf::RenderWindow& window, const sf::Font& font, const sf::Vector2f& position) {
+    if (!overlayVisible) {
+        return;
+    }
+
+    // Refresh the text a few times per second; formatting every frame would skew the numbers
+    if (overlayLines.empty() || ++framesSinceOverlayRefresh >= 15) {
+        refreshOverlayText();
+        framesSinceOverlayRefresh = 0;
+    }
+
+    const float lineHeight = 16.0f;
+
+    sf::RectangleShape background(sf::Vector2f(330.0f, lineHeight * overlayLines.size() + 10.0f));
+    background.setPosition(position);
+    background.setFillColor(sf::Color(0, 0, 0, 180));
+    profiledDraw(window, background);
+
+    sf::Text line;
+    line.setFont(font);
+    line.setCharacterSize(13);
+    line.setFillColor(sf::Color(0, 255, 120));
+
+    for (size_t i = 0; i < overlayLines.size(); i++) {
+        line.setString(overlayLines[i]);
+        line.setPosition(position.x + 6.0f, position.y + 4.0f + i * lineHeight);
+        profiledDraw(window, line);
+    }
+}
+
+const char* Profiler::getSectionName(Section section) {
+    switch (section) {
+        case Section::VISUALIZER_DRAW: return "NetworkVisualizer::draw";
+        case Section::GALLERY_DRAW: return "Gallery::draw";
+        case Section::INPUT_DRAW: return "Input::draw";
+        case Section::BUTTON_UPDATE: return "Button updates";
+        case Section::INFERENCE: return "Inference";
+        default: return "Unknown";
+    }
+}
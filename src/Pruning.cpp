@@ -0,0 +1,120 @@
+#include "../include/Pruning.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    // Mask out the `count` smallest magnitudes among the given layers' weights
+    void pruneSmallest(std::vector<Layer>& layers, const std::vector<size_t>& layerIndices, size_t count) {
+        if (count == 0) {
+            return;
+        }
+
+        std::vector<double> magnitudes;
+        for (size_t l : layerIndices) {
+            for (const auto& neuron : layers[l].getNeurons()) {
+                for (double w : neuron.getWeights()) {
+                    magnitudes.push_back(std::fabs(w));
+                }
+            }
+        }
+        count = std::min(count, magnitudes.size());
+
+        // Prune everything below the count-th smallest magnitude, then ties up to count
+        std::nth_element(magnitudes.begin(), magnitudes.begin() + (count - 1), magnitudes.end());
+        const double threshold = magnitudes[count - 1];
+        size_t belowThreshold = std::count_if(magnitudes.begin(), magnitudes.end(),
+                                              [threshold](double m) { return m < threshold; });
+        size_t tiesToPrune = count - belowThreshold;
+
+        for (size_t l : layerIndices) {
+            Layer& layer = layers[l];
+            std::vector<uint8_t> mask;
+            for (const auto& neuron : layer.getNeurons()) {
+                for (double w : neuron.getWeights()) {
+                    double magnitude = std::fabs(w);
+                    // Zeros stay pruned (earlier steps' masks are rebuilt from them)
+                    bool prune = magnitude < threshold || magnitude == 0.0;
+                    if (!prune && magnitude == threshold && tiesToPrune > 0) {
+                        prune = true;
+                        tiesToPrune--;
+                    }
+                    mask.push_back(prune ? 0 : 1);
+                }
+            }
+            layer.setPruningMask(mask);
+        }
+    }
+}
+
+double PruningStats::getSparsity() const {
+    size_t weights = 0;
+    size_t pruned = 0;
+    for (size_t l = 0; l < layerWeights.size(); l++) {
+        weights += layerWeights[l];
+        pruned += layerPruned[l];
+    }
+    return weights > 0 ? static_cast<double>(pruned) / weights : 0.0;
+}
+
+double PruningStats::getLayerSparsity(size_t layer) const {
+    return layerWeights[layer] > 0 ? static_cast<double>(layerPruned[layer]) / layerWeights[layer] : 0.0;
+}
+
+PruningStats Pruning::pruneByMagnitude(std::vector<Layer>& layers, double sparsity, PruningScope scope) {
+    if (sparsity < 0.0 || sparsity >= 1.0) {
+        throw std::runtime_error("Pruning sparsity must be in [0, 1)");
+    }
+
+    PruningStats before = measure(layers);
+    if (scope == PruningScope::GLOBAL) {
+        std::vector<size_t> all(layers.size());
+        size_t totalWeights = 0;
+        for (size_t l = 0; l < layers.size(); l++) {
+            all[l] = l;
+            totalWeights += before.layerWeights[l];
+        }
+        pruneSmallest(layers, all, static_cast<size_t>(std::llround(sparsity * totalWeights)));
+    } else {
+        for (size_t l = 0; l < layers.size(); l++) {
+            pruneSmallest(layers, {l}, static_cast<size_t>(std::llround(sparsity * before.layerWeights[l])));
+        }
+    }
+
+    return measure(layers);
+}
+
+PruningStats Pruning::pruneAndFinetune(Network& network, double targetSparsity, int steps,
+                                       const std::string& trainFile, int epochsPerStep, int batchSize,
+                                       PruningScope scope) {
+    steps = std::max(1, steps);
+
+    PruningStats stats;
+    for (int step = 1; step <= steps; step++) {
+        // Already-pruned weights are zero, so each step only adds to the mask
+        double sparsity = targetSparsity * step / steps;
+        stats = pruneByMagnitude(network.getLayers(), sparsity, scope);
+        std::cout << "Pruned to " << stats.getSparsity() * 100.0 << "% sparsity, fine-tuning..." << std::endl;
+
+        if (epochsPerStep > 0) {
+            network.train(trainFile, epochsPerStep, batchSize);
+        }
+    }
+
+    return measure(network.getLayers());
+}
+
+PruningStats Pruning::measure(const std::vector<Layer>& layers) {
+    PruningStats stats;
+    for (const auto& layer : layers) {
+        size_t weights = 0;
+        size_t zeros = 0;
+        for (const auto& neuron : layer.getNeurons()) {
+            weights += neuron.getWeights().size();
+            zeros += std::count(neuron.getWeights().begin(), neuron.getWeights().end(), 0.0);
+        }
+        stats.layerWeights.push_back(weights);
+        stats.layerPruned.push_back(zeros);
+    }
+    return stats;
+}
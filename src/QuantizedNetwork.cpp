@@ -0,0 +1,268 @@
+#include "../include/QuantizedNetwork.h"
+#include "../include/Softmax.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define NN_AVX2_KERNEL 1
+#define NN_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define NN_AVX2_KERNEL 1
+#define NN_AVX2_TARGET
+#endif
+
+namespace {
+    constexpr size_t ROW_ALIGNMENT = 32;    // Bytes per AVX2 load
+
+    // Sum of a[i] * w[i] over count (a multiple of ROW_ALIGNMENT) elements
+    int32_t dotScalar(const uint8_t* a, const int8_t* w, size_t count) {
+        int32_t sum = 0;
+        for (size_t i = 0; i < count; i++) {
+            sum += static_cast<int32_t>(a[i]) * static_cast<int32_t>(w[i]);
+        }
+        return sum;
+    }
+
+#ifdef NN_AVX2_KERNEL
+    NN_AVX2_TARGET int32_t dotAvx2(const uint8_t* a, const int8_t* w, size_t count) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t i = 0; i < count; i += ROW_ALIGNMENT) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+            // u8 x s8 -> adjacent pairs summed to int16 (no saturation with a <= 127),
+            // then pairs of int16 summed to int32
+            __m256i pairs = _mm256_maddubs_epi16(va, vw);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+        }
+
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+#endif
+
+    bool cpuSupportsAvx2() {
+#if defined(NN_AVX2_KERNEL) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2");
+#elif defined(NN_AVX2_KERNEL)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // Quantized activations for one inference
+    struct Scratch {
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> next;
+        std::vector<double> values;
+    };
+}
+
+QuantizedNetwork::QuantizedNetwork(const std::vector<Layer>& sourceLayers,
+                                   const std::vector<std::vector<double>>& calibrationInputs)
+    : useAvx2(cpuSupportsAvx2()) {
+    if (sourceLayers.empty()) {
+        throw std::runtime_error("Cannot quantize a network with no layers");
+    }
+    if (calibrationInputs.empty()) {
+        throw std::runtime_error("Quantization needs at least one calibration input");
+    }
+    for (size_t l = 0; l < sourceLayers.size(); l++) {
+        bool isOutput = (l + 1 == sourceLayers.size());
+        ActivationType expected = isOutput ? ActivationType::SOFTMAX : ActivationType::RELU;
+        if (sourceLayers[l].getActivationType() != expected) {
+            throw std::runtime_error("Quantized networks need ReLU hidden layers and a softmax output layer");
+        }
+    }
+
+    // Calibrate: largest input value seen by each layer in double precision
+    std::vector<double> maxInput(sourceLayers.size(), 0.0);
+    for (const auto& sample : calibrationInputs) {
+        std::vector<double> current = sample;
+        for (size_t l = 0; l < sourceLayers.size(); l++) {
+            for (double value : current) {
+                maxInput[l] = std::max(maxInput[l], value);
+            }
+            current = sourceLayers[l].computeOutputs(current);
+        }
+    }
+
+    // Quantize weights per row, and fold the input scale into each row's output scale
+    for (size_t l = 0; l < sourceLayers.size(); l++) {
+        const std::vector<Neuron>& neurons = sourceLayers[l].getNeurons();
+
+        QuantizedLayer layer;
+        layer.inputCount = neurons.front().getWeights().size();
+        layer.outputCount = neurons.size();
+        layer.paddedInputCount = roundUp(layer.inputCount, ROW_ALIGNMENT);
+        layer.weights.assign(layer.outputCount * layer.paddedInputCount, 0);
+        layer.inputScale = maxInput[l] > 0.0 ? static_cast<float>(maxInput[l] / ACTIVATION_MAX) : 1.0f;
+
+        for (size_t o = 0; o < neurons.size(); o++) {
+            const std::vector<double>& row = neurons[o].getWeights();
+            double maxAbs = 0.0;
+            for (double w : row) {
+                maxAbs = std::max(maxAbs, std::fabs(w));
+            }
+            double rowScale = maxAbs > 0.0 ? maxAbs / WEIGHT_MAX : 1.0;
+
+            int8_t* quantizedRow = layer.weights.data() + o * layer.paddedInputCount;
+            for (size_t i = 0; i < row.size(); i++) {
+                quantizedRow[i] = static_cast<int8_t>(std::lround(row[i] / rowScale));
+            }
+            layer.outputScales.push_back(static_cast<float>(rowScale * layer.inputScale));
+            layer.biases.push_back(static_cast<float>(neurons[o].getBias()));
+        }
+
+        layers.push_back(std::move(layer));
+    }
+}
+
+void QuantizedNetwork::quantizeActivations(const double* values, size_t count, float scale, uint8_t* quantized) {
+    const double inverseScale = 1.0 / scale;
+    for (size_t i = 0; i < count; i++) {
+        double q = values[i] * inverseScale + 0.5;
+        q = q < 0.0 ? 0.0 : (q > ACTIVATION_MAX ? ACTIVATION_MAX : q);
+        quantized[i] = static_cast<uint8_t>(q);
+    }
+}
+
+size_t QuantizedNetwork::getInputSize() const {
+    return layers.front().inputCount;
+}
+
+size_t QuantizedNetwork::getOutputSize() const {
+    return layers.back().outputCount;
+}
+
+void QuantizedNetwork::infer(const double* input, double* outputs) const {
+    Scratch& scratch = threadLocalScratch<Scratch>();
+
+    const QuantizedLayer& first = layers.front();
+    scratch.current.assign(first.paddedInputCount, 0);
+    quantizeActivations(input, first.inputCount, first.inputScale, scratch.current.data());
+
+    for (size_t l = 0; l < layers.size(); l++) {
+        const QuantizedLayer& layer = layers[l];
+        bool isOutput = (l + 1 == layers.size());
+
+        // Real weighted sums: int32 dot product, rescaled once per neuron
+        double* sums = outputs;
+        if (!isOutput) {
+            scratch.values.resize(layer.outputCount);
+            sums = scratch.values.data();
+        }
+        for (size_t o = 0; o < layer.outputCount; o++) {
+            const int8_t* row = layer.weights.data() + o * layer.paddedInputCount;
+#ifdef NN_AVX2_KERNEL
+            int32_t dot = useAvx2 ? dotAvx2(scratch.current.data(), row, layer.paddedInputCount)
+                                  : dotScalar(scratch.current.data(), row, layer.paddedInputCount);
+#else
+            int32_t dot = dotScalar(scratch.current.data(), row, layer.paddedInputCount);
+#endif
+            sums[o] = dot * layer.outputScales[o] + layer.biases[o];
+        }
+
+        if (isOutput) {
+            Softmax::forward(outputs, layer.outputCount);
+        } else {
+            // ReLU falls out of the clamp at zero
+            const QuantizedLayer& nextLayer = layers[l + 1];
+            scratch.next.assign(nextLayer.paddedInputCount, 0);
+            quantizeActivations(sums, layer.outputCount, nextLayer.inputScale, scratch.next.data());
+            std::swap(scratch.current, scratch.next);
+        }
+    }
+}
+
+size_t QuantizedNetwork::getModelBytes() const {
+    size_t bytes = 0;
+    for (const auto& layer : layers) {
+        bytes += layer.weights.size() * sizeof(int8_t)
+               + layer.outputScales.size() * sizeof(float)
+               + layer.biases.size() * sizeof(float)
+               + sizeof(layer.inputScale);
+    }
+    return bytes;
+}
+
+bool QuantizedNetwork::isUsingAvx2() const {
+    return useAvx2;
+}
+
+QuantizationReport QuantizedNetwork::compare(const Network& reference,
+                                             const std::vector<std::vector<double>>& inputs,
+                                             const std::vector<std::vector<double>>& targets) const {
+    if (inputs.size() != targets.size()) {
+        throw std::runtime_error("Number of inputs doesn't match number of targets");
+    }
+
+    QuantizationReport report;
+    report.samples = inputs.size();
+    if (inputs.empty()) {
+        return report;
+    }
+
+    std::vector<int> referencePredictions(inputs.size());
+    std::vector<int> quantizedPredictions(inputs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < inputs.size(); i++) {
+        referencePredictions[i] = reference.classify(inputs[i]);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < inputs.size(); i++) {
+        quantizedPredictions[i] = classify(inputs[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    size_t referenceCorrect = 0;
+    size_t quantizedCorrect = 0;
+    size_t agreeing = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        int label = reference.getMaxOutputIndex(targets[i]);
+        referenceCorrect += (referencePredictions[i] == label);
+        quantizedCorrect += (quantizedPredictions[i] == label);
+        agreeing += (referencePredictions[i] == quantizedPredictions[i]);
+    }
+
+    double samples = static_cast<double>(inputs.size());
+    report.referenceAccuracy = referenceCorrect / samples;
+    report.quantizedAccuracy = quantizedCorrect / samples;
+    report.agreement = agreeing / samples;
+    report.referenceMicrosPerSample = std::chrono::duration<double, std::micro>(middle - start).count() / samples;
+    report.quantizedMicrosPerSample = std::chrono::duration<double, std::micro>(end - middle).count() / samples;
+    report.quantizedBytes = getModelBytes();
+    for (const auto& layer : reference.getLayers()) {
+        for (const auto& neuron : layer.getNeurons()) {
+            report.referenceBytes += (neuron.getWeights().size() + 1) * sizeof(double);
+        }
+    }
+
+    return report;
+}
+
+std::string QuantizationReport::toString() const {
+    std::stringstream ss;
+    ss << "Samples:  " << samples << "\n"
+       << "Accuracy: " << referenceAccuracy * 100.0 << "% (double) vs " << quantizedAccuracy * 100.0
+       << "% (int8), delta " << (quantizedAccuracy - referenceAccuracy) * 100.0 << " points, "
+       << agreement * 100.0 << "% identical predictions\n"
+       << "Latency:  " << referenceMicrosPerSample << " us (double) vs " << quantizedMicrosPerSample
+       << " us (int8), " << referenceMicrosPerSample / quantizedMicrosPerSample << "x faster\n"
+       << "Size:     " << referenceBytes << " bytes (double) vs " << quantizedBytes << " bytes (int8), "
+       << static_cast<double>(referenceBytes) / quantizedBytes << "x smaller";
+    return ss.str();
+}
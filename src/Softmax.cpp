@@ -0,0 +1,87 @@
+#include "../include/Softmax.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    constexpr double LOG2E = 1.4426950408889634;
+    constexpr double LN2_HI = 0.693145751953125;          // ln(2) split so k * LN2_HI is exact
+    constexpr double LN2_LO = 1.42860682030941723212e-6;
+    constexpr double ROUNDING_SHIFT = 6755399441055744.0; // 1.5 * 2^52: adding it rounds to an integer
+    constexpr double MIN_EXP_INPUT = -708.0;              // Smallest result that is still a normal double
+    constexpr double MAX_EXP_INPUT = 709.0;
+    constexpr double MIN_PROBABILITY = 1e-10;
+}
+
+void Softmax::fastExp(double* values, size_t count) {
+    // exp(x) = 2^k * exp(r) with k = round(x / ln2) and |r| <= ln2 / 2
+    for (size_t i = 0; i < count; i++) {
+        double x = values[i];
+        x = x < MIN_EXP_INPUT ? MIN_EXP_INPUT : x;
+        x = x > MAX_EXP_INPUT ? MAX_EXP_INPUT : x;
+
+        // The low bits of `shifted` hold k as a two's complement integer
+        double shifted = x * LOG2E + ROUNDING_SHIFT;
+        double k = shifted - ROUNDING_SHIFT;
+        double r = (x - k * LN2_HI) - k * LN2_LO;
+
+        // Degree 8 Taylor polynomial for exp(r) (error below 1e-9 on the reduced range)
+        double p = 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        // Multiply by 2^k by adding k to the exponent field
+        uint64_t kBits;
+        uint64_t pBits;
+        std::memcpy(&kBits, &shifted, sizeof(kBits));
+        std::memcpy(&pBits, &p, sizeof(pBits));
+        pBits += kBits << 52;
+        std::memcpy(&values[i], &pBits, sizeof(pBits));
+    }
+}
+
+double Softmax::forward(double* values, size_t count, const double* targets, double* deltas) {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    // Subtract the max for numerical stability
+    double maxValue = *std::max_element(values, values + count);
+    for (size_t i = 0; i < count; i++) {
+        values[i] -= maxValue;
+    }
+
+    fastExp(values, count);
+
+    double sumExp = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        sumExp += values[i];
+    }
+
+    // Normalize, and with targets accumulate the loss and output deltas in the same pass
+    double invSum = 1.0 / sumExp;
+    double loss = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double probability = values[i] * invSum;
+        values[i] = probability;
+
+        if (targets) {
+            // One-hot targets only pay for one log
+            if (targets[i] != 0.0) {
+                loss -= targets[i] * std::log(std::max(probability, MIN_PROBABILITY));
+            }
+            if (deltas) {
+                deltas[i] = targets[i] - probability;
+            }
+        }
+    }
+
+    return loss;
+}
@@ -0,0 +1,122 @@
+#include "../include/SparseNetwork.h"
+#include "../include/Activation.h"
+#include "../include/Softmax.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // Activations between layers
+    struct Scratch {
+        std::vector<double> current;
+        std::vector<double> next;
+    };
+}
+
+SparseNetwork::SparseNetwork(const std::vector<Layer>& sourceLayers) {
+    if (sourceLayers.empty()) {
+        throw std::runtime_error("Cannot convert a network with no layers");
+    }
+
+    for (const auto& source : sourceLayers) {
+        const std::vector<Neuron>& neurons = source.getNeurons();
+
+        CsrLayer layer;
+        layer.inputCount = neurons.front().getWeights().size();
+        layer.activationType = source.getActivationType();
+        layer.rowOffsets.push_back(0);
+        for (const auto& neuron : neurons) {
+            const std::vector<double>& weights = neuron.getWeights();
+            for (size_t i = 0; i < weights.size(); i++) {
+                if (weights[i] != 0.0) {
+                    layer.columns.push_back(static_cast<uint32_t>(i));
+                    layer.values.push_back(weights[i]);
+                }
+            }
+            layer.rowOffsets.push_back(static_cast<uint32_t>(layer.values.size()));
+            layer.biases.push_back(neuron.getBias());
+        }
+
+        layers.push_back(std::move(layer));
+    }
+}
+
+void SparseNetwork::CsrLayer::multiply(const double* inputs, double* outputs) const {
+    const uint32_t* cols = columns.data();
+    const double* vals = values.data();
+
+    for (size_t row = 0; row + 1 < rowOffsets.size(); row++) {
+        uint32_t k = rowOffsets[row];
+        const uint32_t end = rowOffsets[row + 1];
+
+        // Two accumulators hide the gather latency
+        double sum0 = 0.0;
+        double sum1 = 0.0;
+        for (; k + 2 <= end; k += 2) {
+            sum0 += vals[k] * inputs[cols[k]];
+            sum1 += vals[k + 1] * inputs[cols[k + 1]];
+        }
+        if (k < end) {
+            sum0 += vals[k] * inputs[cols[k]];
+        }
+
+        outputs[row] = biases[row] + (sum0 + sum1);
+    }
+}
+
+size_t SparseNetwork::getInputSize() const {
+    return layers.front().inputCount;
+}
+
+size_t SparseNetwork::getOutputSize() const {
+    return layers.back().biases.size();
+}
+
+void SparseNetwork::infer(const double* input, double* outputs) const {
+    Scratch& scratch = threadLocalScratch<Scratch>();
+    const double* current = input;
+
+    for (size_t l = 0; l < layers.size(); l++) {
+        const CsrLayer& layer = layers[l];
+        size_t outputCount = layer.biases.size();
+        bool isOutput = (l + 1 == layers.size());
+
+        // Weighted sums, then the activation in place of them
+        scratch.next.resize(outputCount);
+        layer.multiply(current, scratch.next.data());
+
+        double* activated = outputs;
+        if (!isOutput) {
+            scratch.current.resize(outputCount);
+            activated = scratch.current.data();
+        }
+        if (layer.activationType == ActivationType::SOFTMAX) {
+            std::copy(scratch.next.begin(), scratch.next.end(), activated);
+            Softmax::forward(activated, outputCount);
+        } else {
+            Activation::apply(layer.activationType, scratch.next.data(), activated, outputCount);
+        }
+
+        current = activated;
+    }
+}
+
+double SparseNetwork::getDensity() const {
+    size_t stored = 0;
+    size_t total = 0;
+    for (const auto& layer : layers) {
+        stored += layer.values.size();
+        total += layer.biases.size() * layer.inputCount;
+    }
+    return total > 0 ? static_cast<double>(stored) / total : 0.0;
+}
+
+size_t SparseNetwork::getModelBytes() const {
+    size_t bytes = 0;
+    for (const auto& layer : layers) {
+        bytes += layer.values.size() * sizeof(double)
+               + layer.columns.size() * sizeof(uint32_t)
+               + layer.rowOffsets.size() * sizeof(uint32_t)
+               + layer.biases.size() * sizeof(double);
+    }
+    return bytes;
+}
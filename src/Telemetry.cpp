@@ -0,0 +1,97 @@
+#include "../include/Telemetry.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifndef NN_ENABLE_ALLOCATION_COUNTING
+// Without the operator new hook (src/AllocationCounter.cpp) nothing is counted
+size_t Telemetry::getAllocationCount() {
+    return 0;
+}
+
+size_t Telemetry::getAllocatedBytes() {
+    return 0;
+}
+
+size_t Telemetry::getThreadAllocationCount() {
+    return 0;
+}
+
+size_t Telemetry::getThreadAllocatedBytes() {
+    return 0;
+}
+#endif
+
+size_t Telemetry::getPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);          // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // Kilobytes on Linux
+#endif
+#endif
+}
+
+double Telemetry::percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(p / 100.0 * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+std::string Telemetry::toJson(const EpochTelemetry& e, double loadSeconds) {
+    std::stringstream ss;
+    ss << "{\"epoch\":" << e.epoch
+       << ",\"samples\":" << e.samples
+       << ",\"batches\":" << e.batches
+       << ",\"loss\":" << e.loss
+       << ",\"wall_seconds\":" << e.wallSeconds
+       << ",\"samples_per_second\":" << e.samplesPerSecond
+       << ",\"batch_latency_p50_ms\":" << e.batchLatencyP50Ms
+       << ",\"batch_latency_p99_ms\":" << e.batchLatencyP99Ms
+       << ",\"batch_latency_max_ms\":" << e.batchLatencyMaxMs
+       << ",\"batch_assembly_seconds\":" << e.batchAssemblySeconds
+       << ",\"compute_seconds\":" << e.computeSeconds
+       << ",\"load_seconds\":" << loadSeconds
+       << ",\"skipped_row_fraction\":" << e.skippedRowFraction
+       << ",\"peak_resident_bytes\":" << e.peakResidentBytes
+       << ",\"allocations\":" << e.allocations
+       << ",\"allocated_bytes\":" << e.allocatedBytes
+       << "}";
+    return ss.str();
+}
+
+bool TrainingTelemetry::appendJsonLines(const std::string& path) const {
+    std::ofstream file(path, std::ios::app);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    for (const auto& epoch : epochs) {
+        file << Telemetry::toJson(epoch, loadSeconds) << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
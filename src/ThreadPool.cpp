@@ -0,0 +1,238 @@
+#include "../include/ThreadPool.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    // Which pool (if any) the current thread works for, and its deque
+    struct WorkerIdentity {
+        const ThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    thread_local WorkerIdentity currentWorker;
+
+    // Options for ThreadPool::global(), fixed on its first use
+    struct GlobalOptions {
+        std::mutex mutex;
+        bool created = false;
+        size_t workerCount = ThreadPool::getDefaultWorkerCount();
+        bool pinWorkers = false;
+    };
+
+    GlobalOptions& globalOptions() {
+        static GlobalOptions options;
+        return options;
+    }
+
+    void pinCurrentThread(size_t cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu % std::max(1u, std::thread::hardware_concurrency()), &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+void ThreadPool::RangeState::fail(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) {
+        error = e;
+    }
+}
+
+void ThreadPool::RangeState::finish(size_t count) {
+    // Under the lock: once the caller sees zero it may return and destroy this state,
+    // which it only does after taking the lock itself (see waitForRange)
+    std::lock_guard<std::mutex> lock(mutex);
+    if (remaining.fetch_sub(count, std::memory_order_acq_rel) == count) {
+        changed.notify_all();
+    }
+}
+
+void ThreadPool::RangeState::notify() {
+    // Taking the lock orders this with the caller checking its wait condition
+    { std::lock_guard<std::mutex> lock(mutex); }
+    changed.notify_all();
+}
+
+ThreadPool::ThreadPool(size_t workerCount, bool pinWorkers)
+    : queuedTasks(0), nextQueue(0), stopping(false) {
+    // Outside submissions need a deque even without workers
+    for (size_t i = 0; i < std::max<size_t>(workerCount, 1); i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i, pinWorkers);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    GlobalOptions& options = globalOptions();
+    {
+        std::lock_guard<std::mutex> lock(options.mutex);
+        options.created = true;
+    }
+    static ThreadPool pool(options.workerCount, options.pinWorkers);
+    return pool;
+}
+
+size_t ThreadPool::getDefaultWorkerCount() {
+    return std::max(1u, std::thread::hardware_concurrency()) - 1;
+}
+
+bool ThreadPool::configureGlobal(size_t workerCount, bool pinWorkers) {
+    GlobalOptions& options = globalOptions();
+    std::lock_guard<std::mutex> lock(options.mutex);
+    if (options.created) {
+        return false;
+    }
+    options.workerCount = workerCount;
+    options.pinWorkers = pinWorkers;
+    return true;
+}
+
+size_t ThreadPool::getWorkerCount() const {
+    return workers.size();
+}
+
+size_t ThreadPool::getConcurrency() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    if (workers.empty()) {
+        task();
+        return;
+    }
+    push({std::move(task), nullptr});
+}
+
+void ThreadPool::push(Task task) {
+    // Workers keep their own tasks; everyone else spreads them out
+    size_t index = currentWorker.pool == this ? currentWorker.index
+                                              : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    RangeState* range = task.range;
+    if (range) {
+        range->queuedPieces.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this with a worker checking queuedTasks before it sleeps
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeUp.notify_one();
+
+    // The range's caller may be asleep with nothing left to run itself
+    if (range) {
+        range->notify();
+    }
+}
+
+bool ThreadPool::tryPop(Task& task, const RangeState* range) {
+    if (queuedTasks.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // Own deque from the back, then steal from the front of the others
+    auto matches = [range](const Task& queued) { return !range || queued.range == range; };
+    auto take = [&](std::deque<Task>& tasks, std::deque<Task>::iterator position) {
+        task = std::move(*position);
+        tasks.erase(position);
+        queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        if (task.range) {
+            task.range->queuedPieces.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return true;
+    };
+
+    bool isWorker = currentWorker.pool == this;
+    size_t start = isWorker ? currentWorker.index : 0;
+    if (isWorker) {
+        WorkerQueue& own = *queues[start];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        auto found = std::find_if(own.tasks.rbegin(), own.tasks.rend(), matches);
+        if (found != own.tasks.rend()) {
+            return take(own.tasks, std::next(found).base());
+        }
+    }
+    for (size_t offset = isWorker ? 1 : 0; offset < queues.size(); offset++) {
+        WorkerQueue& victim = *queues[(start + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        auto found = std::find_if(victim.tasks.begin(), victim.tasks.end(), matches);
+        if (found != victim.tasks.end()) {
+            return take(victim.tasks, found);
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (!tryPop(task)) {
+        return false;
+    }
+    task.function();
+    return true;
+}
+
+void ThreadPool::waitForRange(RangeState& state) {
+    while (state.remaining.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (tryPop(task, &state)) {
+            task.function();
+            continue;
+        }
+
+        // Other threads hold the rest; sleep until they finish or queue more pieces
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.changed.wait(lock, [&state] {
+            return state.remaining.load(std::memory_order_acquire) == 0
+                || state.queuedPieces.load(std::memory_order_relaxed) > 0;
+        });
+    }
+
+    // Wait for the thread that finished the last piece to let go of the state
+    std::lock_guard<std::mutex> lock(state.mutex);
+}
+
+void ThreadPool::workerLoop(size_t index, bool pin) {
+    currentWorker.pool = this;
+    currentWorker.index = index;
+    if (pin) {
+        // CPU 0 is left for the thread that created the pool
+        pinCurrentThread(index + 1);
+    }
+
+    while (true) {
+        if (runPendingTask()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this] { return stopping || queuedTasks.load(std::memory_order_acquire) > 0; });
+        if (stopping && queuedTasks.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#include "../include/Trace.h"
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+namespace {
+    // Events recorded by one thread; kept alive in the registry after the thread exits
+    struct ThreadBuffer {
+        std::vector<Tracer::Event> events;
+        uint32_t threadId = 0;
+        size_t dropped = 0;
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    };
+
+    // Timestamps are relative to program start
+    const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // The calling thread's buffer, registered on first use (the only locked step)
+    ThreadBuffer& localBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer;
+        if (!buffer) {
+            buffer = std::make_shared<ThreadBuffer>();
+            buffer->events.reserve(4096);
+
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            buffer->threadId = static_cast<uint32_t>(reg.buffers.size() + 1);
+            reg.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+}
+
+Tracer::Scope::Scope(const char* spanName, const char* spanArgName, int64_t spanArgValue)
+    : name(spanName), argName(spanArgName), argValue(spanArgValue), start(std::chrono::steady_clock::now()) {
+}
+
+Tracer::Scope::~Scope() {
+    Tracer::record(name, argName, argValue, start, std::chrono::steady_clock::now());
+}
+
+void Tracer::record(const char* name, const char* argName, int64_t argValue,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end) {
+    ThreadBuffer& buffer = localBuffer();
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        buffer.dropped++;
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.argName = argName;
+    event.argValue = argValue;
+    event.startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(start - traceEpoch).count();
+    event.durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    buffer.events.push_back(event);
+}
+
+// Call while no other thread is recording spans
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // Complete ("X") events with microsecond timestamps, one track per thread
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : reg.buffers) {
+        for (const Event& event : buffer->events) {
+            file << (first ? "" : ",\n")
+                 << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0;
+            if (event.argName) {
+                file << ",\"args\":{\"" << event.argName << "\":" << event.argValue << "}";
+            }
+            file << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+// Call while no other thread is recording spans
+void Tracer::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers) {
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+}
+
+size_t Tracer::getEventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (const auto& buffer : reg.buffers) {
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+size_t Tracer::getDroppedCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    size_t count = 0;
+    for (const auto& buffer : reg.buffers) {
+        count += buffer->dropped;
+    }
+    return count;
+}
@@ -0,0 +1,114 @@
+#include "../include/WeightSnapshot.h"
+#include <algorithm>
+
+std::vector<std::vector<double>> NetworkSnapshot::getAllActivations(const std::vector<double>& input) const {
+    std::vector<std::vector<double>> allActivations;
+
+    if (layers.empty()) {
+        return allActivations;
+    }
+
+    allActivations.push_back(input);
+    for (const auto& layer : layers) {
+        allActivations.push_back(layer.computeOutputs(allActivations.back()));
+    }
+
+    return allActivations;
+}
+
+int NetworkSnapshot::predict(const std::vector<double>& input) const {
+    if (layers.empty()) {
+        throw std::runtime_error("Snapshot has no layers");
+    }
+
+    std::vector<double> outputs = input;
+    for (const auto& layer : layers) {
+        outputs = layer.computeOutputs(outputs);
+    }
+
+    return static_cast<int>(std::distance(outputs.begin(), std::max_element(outputs.begin(), outputs.end())));
+}
+
+SnapshotPublisher::SnapshotPublisher(std::chrono::milliseconds minPublishInterval, double maxOverhead)
+    : nextVersion(1), minInterval(minPublishInterval), maxOverheadFraction(maxOverhead), started(false) {
+}
+
+void SnapshotPublisher::publish(const std::vector<Layer>& layers) {
+    auto start = std::chrono::steady_clock::now();
+    if (!started) {
+        started = true;
+        firstCall = start;
+    }
+
+    // Reuse the spare snapshot's memory if no reader still holds it. Readers can
+    // only obtain snapshots through `current`, so once the spare's count drops to
+    // one it stays there; the fence pairs with the readers' releasing decrements.
+    std::shared_ptr<NetworkSnapshot> next;
+    if (spare && spare.use_count() == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next = std::move(spare);
+    } else {
+        // Readers still use the old one; they free it when done
+        spare.reset();
+        next = std::make_shared<NetworkSnapshot>();
+    }
+
+    next->layers = layers;  // Copy-assignment reuses the existing weight storage
+    next->version = nextVersion++;
+
+    // Swap it in; the previous snapshot becomes the spare for the next publish
+    std::shared_ptr<const NetworkSnapshot> previous =
+        std::atomic_exchange(&current, std::shared_ptr<const NetworkSnapshot>(next));
+    spare = std::const_pointer_cast<NetworkSnapshot>(previous);
+
+    // Cost accounting
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    stats.publishCount++;
+    stats.totalPublishSeconds += seconds;
+    stats.maxPublishSeconds = std::max(stats.maxPublishSeconds, seconds);
+    lastPublish = end;
+}
+
+bool SnapshotPublisher::publishIfDue(const std::vector<Layer>& layers) {
+    auto now = std::chrono::steady_clock::now();
+
+    // Always publish the first snapshot so readers have something to use
+    if (!started || !std::atomic_load(&current)) {
+        publish(layers);
+        return true;
+    }
+
+    if (now - lastPublish < minInterval) {
+        stats.skippedCount++;
+        return false;
+    }
+
+    // Only publish if one more (worst-case) publish keeps us within the overhead budget
+    double elapsed = std::chrono::duration<double>(now - firstCall).count();
+    if (stats.totalPublishSeconds + stats.maxPublishSeconds > maxOverheadFraction * elapsed) {
+        stats.skippedCount++;
+        return false;
+    }
+
+    publish(layers);
+    return true;
+}
+
+std::shared_ptr<const NetworkSnapshot> SnapshotPublisher::acquire() const {
+    return std::atomic_load(&current);
+}
+
+SnapshotPublishStats SnapshotPublisher::getStats() const {
+    SnapshotPublishStats result = stats;
+    if (started) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - firstCall).count();
+        result.overheadFraction = elapsed > 0.0 ? stats.totalPublishSeconds / elapsed : 0.0;
+    }
+    return result;
+}
+
+void SnapshotPublisher::resetStats() {
+    stats = SnapshotPublishStats();
+    started = false;
+}
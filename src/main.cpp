@@ -3,6 +3,9 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 #include "../include/Neuron.h"
 #include "../include/Layer.h"
@@ -10,6 +13,11 @@
 #include "../include/Input.h"
 #include "../include/Button.h"
 #include "../include/NetworkVisualizer.h"
+#include "../include/Gallery.h"
+#include "../include/Profiler.h"
+#include "../include/MetricsPlot.h"
+#include "../include/WeightSnapshot.h"
+#include "../include/Trace.h"
 
 int main() {
     std::cout << "Starting application..." << std::endl;
@@ -39,7 +47,7 @@ int main() {
     
     // Try to load the MNIST data with error handling
     try {
-        bool loaded = inputDisplay.loadData("data/mnist_data_test.csv", 100);
+        bool loaded = inputDisplay.loadData("data/mnist_data_test.csv");
         if (!loaded) {
             std::cerr << "Failed to load MNIST data" << std::endl;
         } else {
@@ -65,10 +73,52 @@ int main() {
     predictionText.setPosition(350, 50);
     predictionText.setString("Prediction: None");
     
+    // Frame profiler (overlay toggled with F3)
+    Profiler profiler;
+    
     // First, create the visualizer before any buttons that use it
     NetworkVisualizer visualizer(&network, sf::Vector2f(450, 200), sf::Vector2f(400, 300), font);
     visualizer.updateNetworkStructure();  // Initialize visualization
 
+    // Gallery of all loaded samples, shown in place of the visualization when toggled
+    Gallery gallery(sf::Vector2f(440, 170), sf::Vector2f(420, 360), font);
+    gallery.setSamples(inputDisplay.getImages(), inputDisplay.getLabels());
+    bool galleryVisible = false;
+
+    // Live training metrics: the trainer pushes per-batch metrics, the plot drains them each frame
+    TrainingMetricsBuffer metricsBuffer;
+    network.setMetricsBuffer(&metricsBuffer);
+    MetricsPlot metricsPlot(sf::Vector2f(300, 610), sf::Vector2f(370, 140), font);
+    
+    // Training runs on a background thread so the window (and the plot) stay responsive
+    std::thread trainingThread;
+    std::atomic<bool> trainingInProgress(false);
+    
+    // Set by the training thread when a run fails; shown once the main loop joins it
+    std::mutex trainingErrorMutex;
+    std::string trainingError;
+    
+    // Readers get consistent weights from snapshots the trainer publishes while it runs
+    SnapshotPublisher snapshotPublisher;
+    network.setSnapshotPublisher(&snapshotPublisher);
+    
+    // Latest consistent weights: the trainer's last snapshot while training, otherwise taken now
+    auto latestSnapshot = [&]() {
+        if (!trainingInProgress.load()) {
+            snapshotPublisher.publish(network.getLayers());
+        }
+        return snapshotPublisher.acquire();
+    };
+    
+    // Operations that modify the weights or structure must wait until training finishes
+    auto networkBusy = [&]() {
+        if (trainingInProgress.load()) {
+            statusText.setString("Status: Training in progress, please wait...");
+            return true;
+        }
+        return false;
+    };
+
     // Create buttons for neural network operations
     std::vector<Button> buttons;
     
@@ -79,6 +129,10 @@ int main() {
         "Add Hidden Layer", &font, 
         [&]() {
             try {
+                if (networkBusy()) {
+                    return;
+                }
+                
                 // Small layer for demo purposes
                 network.addLayer(16, ActivationType::RELU);
                 statusText.setString("Status: Added hidden layer with 16 neurons");
@@ -99,6 +153,10 @@ int main() {
         "Add Output Layer", &font, 
         [&]() {
             try {
+                if (networkBusy()) {
+                    return;
+                }
+                
                 // Output layer has 10 neurons (one for each digit 0-9)
                 network.addLayer(10, ActivationType::SOFTMAX);
                 statusText.setString("Status: Added output layer with 10 neurons");
@@ -119,6 +177,10 @@ int main() {
         "Build Network", &font, 
         [&]() {
             try {
+                if (networkBusy()) {
+                    return;
+                }
+                
                 if (network.getLayerCount() < 2) {
                     statusText.setString("Status: Add at least one hidden layer and output layer first");
                     return;
@@ -157,16 +219,34 @@ int main() {
                     return;
                 }
                 
-                statusText.setString("Status: Training network (1 epoch), please wait...");
-                window.draw(statusText);
-                window.display();  // Force update the display
+                if (trainingInProgress.load()) {
+                    statusText.setString("Status: Training already in progress");
+                    return;
+                }
                 
-                // Train for just 1 epoch on a very small subset (50 samples)
-                std::string trainFile = "data/mnist_data_train.csv";
-                network.train(trainFile, 1, 10);  // 1 epoch, batch size 10
+                // A finished run may not have been picked up by the main loop yet
+                if (trainingThread.joinable()) {
+                    trainingThread.join();
+                }
                 
-                statusText.setString("Status: Training complete!");
-                std::cout << "Training completed successfully" << std::endl;
+                statusText.setString("Status: Training network (1 epoch)...");
+                trainingInProgress.store(true);
+                
+                // Train for 1 epoch in the background; the main loop picks up completion
+                {
+                    std::lock_guard<std::mutex> lock(trainingErrorMutex);
+                    trainingError.clear();
+                }
+                trainingThread = std::thread([&]() {
+                    try {
+                        std::string trainFile = "data/mnist_data_train.csv";
+                        network.train(trainFile, 1, 10);  // 1 epoch, batch size 10
+                    } catch (const std::exception& e) {
+                        std::lock_guard<std::mutex> lock(trainingErrorMutex);
+                        trainingError = e.what();
+                    }
+                    trainingInProgress.store(false);
+                });
             } catch (const std::exception& e) {
                 std::cerr << "Error during training: " << e.what() << std::endl;
                 statusText.setString("Status: Error during training: " + std::string(e.what()));
@@ -180,6 +260,10 @@ int main() {
         "Test (100 samples)", &font, 
         [&]() {
             try {
+                if (networkBusy()) {
+                    return;
+                }
+                
                 if (network.getLayerCount() < 2) {
                     statusText.setString("Status: Add at least one hidden layer and output layer first");
                     return;
@@ -241,8 +325,19 @@ int main() {
                 // Get current image and predict
                 std::vector<double> input = inputDisplay.getCurrentImageVector();
                 
+                // Use a weight snapshot, so this also works while training is updating the weights
+                std::shared_ptr<const NetworkSnapshot> snapshot = latestSnapshot();
+                if (!snapshot) {
+                    statusText.setString("Status: Waiting for the first weight snapshot from training");
+                    return;
+                }
+                
                 // First, get all activations for visualization
-                std::vector<std::vector<double>> allActivations = network.getAllActivations(input);
+                std::vector<std::vector<double>> allActivations;
+                {
+                    Profiler::ScopedTimer timer(profiler, Profiler::Section::INFERENCE);
+                    allActivations = snapshot->getAllActivations(input);
+                }
                 
                 // Update the visualizer with these exact activations
                 visualizer.updateWithActivations(allActivations);
@@ -271,6 +366,25 @@ int main() {
         }
     );
     
+    // Gallery toggle button
+    size_t galleryButtonIndex = buttons.size();
+    buttons.emplace_back(
+        sf::Vector2f(50, 650), sf::Vector2f(200, 40), 
+        "Show Gallery", &font, 
+        [&]() {
+            galleryVisible = !galleryVisible;
+            buttons[galleryButtonIndex].setText(galleryVisible ? "Hide Gallery" : "Show Gallery");
+            
+            // Classify the samples with the current weights when the gallery opens
+            // (while training, with the latest snapshot; again once training finishes)
+            if (galleryVisible) {
+                gallery.startPredictions(latestSnapshot());
+                statusText.setString("Status: Gallery with " + std::to_string(gallery.getSampleCount()) +
+                                     " samples (scroll to browse, click to select)");
+            }
+        }
+    );
+    
     std::cout << "Entering main loop" << std::endl;
     
     // Set application color scheme
@@ -352,6 +466,35 @@ int main() {
     
     // Main loop
     while (window.isOpen()) {
+        profiler.beginFrame();
+        
+        // Pick up background training completion
+        if (trainingThread.joinable() && !trainingInProgress.load()) {
+            trainingThread.join();
+            
+            std::string error;
+            {
+                std::lock_guard<std::mutex> lock(trainingErrorMutex);
+                error.swap(trainingError);
+            }
+            
+            if (!error.empty()) {
+                std::cerr << "Error during training: " << error << std::endl;
+                statusText.setString("Status: Error during training: " + error);
+            } else {
+                statusText.setString("Status: Training complete!");
+                std::cout << "Training completed successfully" << std::endl;
+                
+                // Re-classify the gallery with the new weights
+                if (galleryVisible) {
+                    gallery.startPredictions(latestSnapshot());
+                }
+            }
+        }
+        
+        // Append any new training metrics to the plot
+        metricsPlot.consume(metricsBuffer);
+        
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) {
@@ -361,6 +504,7 @@ int main() {
                 sf::Vector2i mousePos = sf::Mouse::getPosition(window);
                 
                 // Update all buttons
+                Profiler::ScopedTimer timer(profiler, Profiler::Section::BUTTON_UPDATE);
                 for (auto& button : buttons) {
                     button.update(mousePos);
                 }
@@ -381,6 +525,24 @@ int main() {
                     for (auto& button : buttons) {
                         button.handleMouseRelease(mousePos);
                     }
+                    
+                    // Select the clicked gallery sample
+                    if (galleryVisible) {
+                        int sampleIndex = gallery.getSampleIndexAt(mousePos);
+                        if (sampleIndex >= 0) {
+                            inputDisplay.setCurrentIndex(static_cast<size_t>(sampleIndex));
+                        }
+                    }
+                }
+            }
+            else if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::F3) {
+                    profiler.toggleOverlay();
+                }
+            }
+            else if (event.type == sf::Event::MouseWheelScrolled) {
+                if (galleryVisible) {
+                    gallery.scroll(event.mouseWheelScroll.delta);
                 }
             }
         }
@@ -389,15 +551,25 @@ int main() {
         window.clear(bgColor);
         
         // Draw panels first
-        window.draw(imagePanel);
-        window.draw(controlPanel);
-        window.draw(visualizationPanel);
+        profiledDraw(window, imagePanel);
+        profiledDraw(window, controlPanel);
+        profiledDraw(window, visualizationPanel);
 
         // Draw input display
-        inputDisplay.draw(window);
+        {
+            Profiler::ScopedTimer timer(profiler, Profiler::Section::INPUT_DRAW);
+            inputDisplay.draw(window);
+        }
 
-        // Draw neural network visualization
-        visualizer.draw(window);
+        // Draw neural network visualization, or the gallery in its place
+        if (galleryVisible) {
+            Profiler::ScopedTimer timer(profiler, Profiler::Section::GALLERY_DRAW);
+            gallery.update();
+            gallery.draw(window);
+        } else {
+            Profiler::ScopedTimer timer(profiler, Profiler::Section::VISUALIZER_DRAW);
+            visualizer.draw(window);
+        }
 
         // Draw texts with updated colors
         statusText.setFillColor(textColor);
@@ -407,25 +579,48 @@ int main() {
         hiddenLabel.setFillColor(textColor);
         outputLabel.setFillColor(textColor);
 
-        window.draw(statusText);
-        window.draw(predictionText);
-        window.draw(networkTitle);
-        window.draw(inputLabel);
-        window.draw(hiddenLabel);
-        window.draw(outputLabel);
+        profiledDraw(window, statusText);
+        profiledDraw(window, predictionText);
+        if (!galleryVisible) {
+            profiledDraw(window, networkTitle);
+            profiledDraw(window, inputLabel);
+            profiledDraw(window, hiddenLabel);
+            profiledDraw(window, outputLabel);
+        }
 
         // Draw all buttons
         for (const auto& button : buttons) {
             button.draw(window);
         }
         
+        // Draw live training metrics
+        metricsPlot.draw(window);
+        
         // Draw title and separator
-        window.draw(appTitle);
-        window.draw(headerSeparator);
+        profiledDraw(window, appTitle);
+        profiledDraw(window, headerSeparator);
+        
+        profiler.endFrame();
+        
+        // Profiler overlay goes on top and is not counted in the frame's own numbers
+        profiler.drawOverlay(window, font, sf::Vector2f(680, 600));
         
         // Display the window contents
         window.display();
     }
     
+    // Stop any training still running before the network goes away
+    if (trainingThread.joinable()) {
+        network.requestStop();
+        trainingThread.join();
+    }
+    
+#ifdef NN_ENABLE_TRACING
+    // Export the session's trace spans (open in chrome://tracing or ui.perfetto.dev)
+    if (Tracer::writeChromeTrace("trace.json")) {
+        std::cout << "Wrote " << Tracer::getEventCount() << " trace events to trace.json" << std::endl;
+    }
+#endif
+    
     return 0;
 }
\ No newline at end of file
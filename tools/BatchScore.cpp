@@ -0,0 +1,79 @@
+#include "BatchScorer.h"
+#include "Network.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <string>
+
+#ifndef NN_DATA_DIR
+#define NN_DATA_DIR "data"
+#endif
+
+// Offline scoring: batch_score --input=images.csv --output=predictions.csv
+int main(int argc, char** argv) {
+    ScoringOptions options;
+    std::string inputPath;
+    std::string outputPath;
+    std::string dataDir = NN_DATA_DIR;
+    int epochs = 5;
+
+    auto printUsage = [argv] {
+        std::cerr << "Usage: " << argv[0] << " --input=path --output=path [--threads=n] [--chunk=lines]"
+                  << " [--batch=n] [--classes-only] [--pin] [--epochs=n] [--data-dir=path]" << std::endl;
+    };
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto valueOf = [&arg](const std::string& prefix) { return arg.substr(prefix.size()); };
+        try {
+            if (arg.rfind("--input=", 0) == 0) {
+                inputPath = valueOf("--input=");
+            } else if (arg.rfind("--output=", 0) == 0) {
+                outputPath = valueOf("--output=");
+            } else if (arg.rfind("--threads=", 0) == 0) {
+                options.threads = std::stoul(valueOf("--threads="));
+            } else if (arg.rfind("--chunk=", 0) == 0) {
+                options.chunkSamples = std::stoul(valueOf("--chunk="));
+            } else if (arg.rfind("--batch=", 0) == 0) {
+                options.batchSize = std::stoul(valueOf("--batch="));
+            } else if (arg == "--classes-only") {
+                options.writeProbabilities = false;
+            } else if (arg == "--pin") {
+                // Before anything uses the shared pool
+                ThreadPool::configureGlobal(ThreadPool::getDefaultWorkerCount(), true);
+            } else if (arg.rfind("--epochs=", 0) == 0) {
+                epochs = std::stoi(valueOf("--epochs="));
+            } else if (arg.rfind("--data-dir=", 0) == 0) {
+                dataDir = valueOf("--data-dir=");
+            } else {
+                throw std::invalid_argument(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Unknown or invalid argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+    if (inputPath.empty() || outputPath.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    // The network has no file format, so train the scoring model first
+    Network network(0.01);
+    network.addLayer(128, ActivationType::RELU);
+    network.addLayer(10, ActivationType::SOFTMAX);
+    network.train(dataDir + "/mnist_data_train.csv", epochs, 10);
+
+    try {
+        BatchScorer scorer(network, options);
+        ScoringStats stats = scorer.score(inputPath, outputPath);
+        std::cout << "Scored " << stats.samples << " samples in " << stats.seconds << " s ("
+                  << stats.samplesPerSecond * 60.0 << " samples/min, " << stats.bytesRead / 1e6 << " MB read, "
+                  << stats.bytesWritten / 1e6 << " MB written)" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Scoring failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}